@@ -2,12 +2,18 @@
 
 #include <QString>
 #include <QVector>
+#include <algorithm>
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace s21 {
 
 Controller::Controller(CalculatorModel &calc, CreditModel &credit)
-    : calc_(calc), credit_(credit) {}
+    : calc_(calc),
+      credit_(credit),
+      plotter_(calc.SamplingPool(), calc.Cache(),
+               std::make_shared<TileCache>()) {}
 
 bool Controller::isContainingX(const QString &input) {
   if (input.isEmpty()) {
@@ -16,6 +22,17 @@ bool Controller::isContainingX(const QString &input) {
   return calc_.isContainingX(input.toStdString());
 }
 
+ParseStatus Controller::Prepare(const QString &input) {
+  if (input.isEmpty()) {
+    return ParseStatus();
+  }
+  return calc_.Prepare(input.toStdString());
+}
+
+ParseStatus Controller::PrepareEdit(const QString &input, bool &changed) {
+  return calc_.PrepareEdit(input.toStdString(), changed);
+}
+
 double Controller::Calculate(const QString &input, double x) {
   if (input.isEmpty()) {
     return 0;
@@ -37,6 +54,89 @@ std::pair<QVector<double>, QVector<double>> Controller::Calculate(
       QVector<double>(pair.second.begin(), pair.second.end()));
 }
 
+std::pair<QVector<double>, QVector<double>> Controller::CalculateAdaptive(
+    const QString &input, double low_x, double high_x, double low_y,
+    double high_y, size_t max_points, double width, double height) {
+  if (input.isEmpty()) {
+    return std::pair<QVector<double>, QVector<double>>(QVector<double>(),
+                                                       QVector<double>());
+  }
+  SamplingOptions options;
+  options.max_points = max_points;
+  options.initial_points = std::min<size_t>(options.initial_points, max_points);
+  options.width = width;
+  options.height = height;
+  std::pair<std::vector<double>, std::vector<double>> pair =
+      calc_.CalculateAdaptive(input.toStdString(), low_x, high_x, low_y,
+                              high_y, options);
+  return std::pair<QVector<double>, QVector<double>>(
+      QVector<double>(pair.first.begin(), pair.first.end()),
+      QVector<double>(pair.second.begin(), pair.second.end()));
+}
+
+void Controller::OnPlotReady(PlotWorker::Callback done) {
+  plotter_.SetCallback(std::move(done));
+}
+
+size_t Controller::PlotAsync(const QString &input, double low_x,
+                             double high_x, double low_y, double high_y,
+                             size_t max_points, double width, double height,
+                             double pixel_ratio, bool view_only,
+                             PlotRequest::Sink sink) {
+  PlotRequest request;
+  request.input = input.toStdString();
+  request.low_x = low_x;
+  request.high_x = high_x;
+  request.low_y = low_y;
+  request.high_y = high_y;
+  request.sampling = ViewportSampling(width, height, pixel_ratio, max_points);
+  request.range = request.markers = request.integral = !view_only;
+  request.sink = std::move(sink);
+  return plotter_.Submit(std::move(request));
+}
+
+void Controller::CancelPlot() { plotter_.Cancel(); }
+
+TileCache::Statistics Controller::TileStatistics() const {
+  return plotter_.Tiles()->Stats();
+}
+
+QVector<double> Controller::FindRoots(const QString &input, double low_x,
+                                      double high_x) {
+  if (input.isEmpty()) {
+    return QVector<double>();
+  }
+  std::vector<double> roots =
+      calc_.FindRoots(input.toStdString(), low_x, high_x);
+  return QVector<double>(roots.begin(), roots.end());
+}
+
+QVector<Extremum> Controller::FindExtrema(const QString &input, double low_x,
+                                          double high_x) {
+  if (input.isEmpty()) {
+    return QVector<Extremum>();
+  }
+  std::vector<Extremum> extrema =
+      calc_.FindExtrema(input.toStdString(), low_x, high_x);
+  return QVector<Extremum>(extrema.begin(), extrema.end());
+}
+
+Integral Controller::Integrate(const QString &input, double low_x,
+                               double high_x) {
+  if (input.isEmpty()) {
+    return Integral();
+  }
+  return calc_.Integrate(input.toStdString(), low_x, high_x);
+}
+
+Interval Controller::EstimateRange(const QString &input, double low_x,
+                                   double high_x) {
+  if (input.isEmpty()) {
+    return Interval::Empty();
+  }
+  return calc_.EstimateRange(input.toStdString(), low_x, high_x);
+}
+
 QVector<QVector<QString>> Controller::Loan(double amount, double term,
                                            double interest, bool is_annuity) {
   std::vector<std::array<double, 4>> rows;
@@ -6,6 +6,7 @@
 
 #include "../model/calculator.h"
 #include "../model/credit.h"
+#include "../model/plot_worker.h"
 
 namespace s21 {
 
@@ -14,16 +15,39 @@ class Controller {
   Controller(CalculatorModel &calc, CreditModel &credit);
 
   bool isContainingX(const QString &input);
+  ParseStatus Prepare(const QString &input);
+  ParseStatus PrepareEdit(const QString &input, bool &changed);
   double Calculate(const QString &input, double x);
   std::pair<QVector<double>, QVector<double>> Calculate(
       const QString &input, double low_x, double high_x, double low_y,
       double high_y, size_t points);
+  std::pair<QVector<double>, QVector<double>> CalculateAdaptive(
+      const QString &input, double low_x, double high_x, double low_y,
+      double high_y, size_t max_points, double width, double height);
+  QVector<double> FindRoots(const QString &input, double low_x, double high_x);
+  QVector<Extremum> FindExtrema(const QString &input, double low_x,
+                                double high_x);
+  Integral Integrate(const QString &input, double low_x, double high_x);
+  Interval EstimateRange(const QString &input, double low_x, double high_x);
+  // Plots on a background thread, the newest call cancelling older ones;
+  // done, and sink when given, run on that thread as in PlotWorker. Width
+  // and height are in logical pixels, sampled as in ViewportSampling, by
+  // tiles that are kept for later views. A view_only plot is the curve
+  // alone, without range, markers and integral.
+  void OnPlotReady(PlotWorker::Callback done);
+  size_t PlotAsync(const QString &input, double low_x, double high_x,
+                   double low_y, double high_y, size_t max_points,
+                   double width, double height, double pixel_ratio,
+                   bool view_only, PlotRequest::Sink sink = nullptr);
+  void CancelPlot();
+  TileCache::Statistics TileStatistics() const;
   QVector<QStringList> Loan(double amount, double term, double interest,
                             bool is_annuity);
 
  private:
   CalculatorModel &calc_;
   CreditModel &credit_;
+  PlotWorker plotter_;
 };
 
 };  // namespace s21
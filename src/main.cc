@@ -9,6 +9,7 @@ int main(int argc, char *argv[]) {
   s21::CalculatorModel model;
 
   s21::CalculatorModel calc;
+  calc.EnableParallelSampling(true);
   s21::CreditModel credit;
   s21::Controller controller(calc, credit);
   s21::View view(controller);
@@ -1,26 +1,31 @@
 #include "calculator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <cmath>
-#include <cstring>
+#include <memory>
 #include <stack>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace s21 {
 
 bool CalculatorModel::isContainingX(const std::string &input) {
   UpdateRpn(input);
-  for (auto lex : rpn_) {
-    if (lex.isVar()) {
-      return true;
-    }
-  }
-  return false;
+  return expression_->isContainingX();
 }
 
 double CalculatorModel::Calculate(const std::string &input, double x) {
   UpdateRpn(input);
-  return Solve(x);
+  return expression_->Evaluate(x);
+}
+
+double CalculatorModel::CalculateReference(const std::string &input,
+                                           double x) {
+  UpdateRpn(input);
+  return expression_->EvaluateReference(x);
 }
 
 std::pair<std::vector<double>, std::vector<double>> CalculatorModel::Calculate(
@@ -33,82 +38,433 @@ std::pair<std::vector<double>, std::vector<double>> CalculatorModel::Calculate(
   double x = low_x;
   for (size_t i = 0; i < points; ++i, x += d) {
     xv[i] = x;
-    double y = Solve(x);
-    if ((y >= low_y && y <= high_y) || (low_y == 0 && high_y == 0)) {
-      yv[i] = Solve(x);
+  }
+  // Blocks whose enclosure misses [low_y, high_y] are never evaluated, and
+  // only blocks that may leave it are clipped point by point.
+  bool clip = low_y != 0 || high_y != 0;
+  std::atomic<size_t> evaluated{0};
+  auto sample = [&](size_t begin, size_t end) {
+    for (size_t from = begin; from < end; from += kCullBlock) {
+      size_t to = std::min(end, from + kCullBlock);
+      Interval y = clip ? expression_->Enclose(xv[from], xv[to - 1])
+                        : Interval::Whole();
+      if (y.isEmpty() || y.high < low_y || y.low > high_y) {
+        std::fill(yv.begin() + from, yv.begin() + to, NAN);
+        continue;
+      }
+      expression_->EvaluateBatch(xv.data() + from, yv.data() + from,
+                                to - from);
+      evaluated += to - from;
+      if (clip && !(y.low >= low_y && y.high <= high_y)) {
+        for (size_t i = from; i < to; ++i) {
+          if (!(yv[i] >= low_y && yv[i] <= high_y)) {
+            yv[i] = NAN;
+          }
+        }
+      }
+    }
+  };
+  if (pool_) {
+    pool_->ParallelFor(points, grain_, sample);
+  } else {
+    sample(0, points);
+  }
+  evaluations_ = evaluated;
+
+  return std::pair<std::vector<double>, std::vector<double>>(std::move(xv),
+                                                             std::move(yv));
+}
+
+std::pair<std::vector<double>, std::vector<double>>
+CalculatorModel::CalculateAdaptive(const std::string &input, double low_x,
+                                   double high_x, double low_y, double high_y,
+                                   const SamplingOptions &options) {
+  UpdateRpn(input);
+  AdaptiveSampler sampler(options);
+  auto evaluate = [this](const double *xs, double *out, size_t count) {
+    if (pool_) {
+      expression_->EvaluateBatch(xs, out, count, *pool_, grain_);
     } else {
-      yv[i] = NAN;
+      expression_->EvaluateBatch(xs, out, count);
+    }
+  };
+  auto enclose = [this](double low, double high) {
+    return expression_->Enclose(low, high);
+  };
+  auto xy = sampler.Sample(evaluate, low_x, high_x, low_y, high_y, enclose);
+  evaluations_ = sampler.Evaluations();
+  return xy;
+}
+
+size_t CalculatorModel::LastEvaluationCount() const noexcept {
+  return evaluations_;
+}
+
+Interval CalculatorModel::EstimateRange(const std::string &input,
+                                        double low_x, double high_x,
+                                        size_t pieces) {
+  UpdateRpn(input);
+  Interval range = Interval::Empty();
+  range.partial = false;
+  pieces = std::max<size_t>(pieces, 1);
+  double step = (high_x - low_x) / pieces;
+  for (size_t i = 0; i < pieces; ++i) {
+    double to = i + 1 == pieces ? high_x : low_x + step * (i + 1);
+    Interval y = expression_->Enclose(low_x + step * i, to);
+    if (y.isBounded()) {
+      range.low = std::min(range.low, y.low);
+      range.high = std::max(range.high, y.high);
+      range.partial |= y.partial;
     }
   }
+  return range;
+}
+
+void CalculatorModel::EvaluateBatch(const std::string &input,
+                                    const double *xs, double *out,
+                                    size_t count) {
+  UpdateRpn(input);
+  if (pool_) {
+    expression_->EvaluateBatch(xs, out, count, *pool_, grain_);
+  } else {
+    expression_->EvaluateBatch(xs, out, count);
+  }
+}
+
+void CalculatorModel::EvaluateDerivatives(const std::string &input,
+                                          const double *xs, double *values,
+                                          double *first, double *second,
+                                          size_t count) {
+  UpdateRpn(input);
+  if (pool_) {
+    expression_->EvaluateDerivatives(xs, values, first, second, count, *pool_,
+                                    grain_);
+  } else {
+    expression_->EvaluateDerivatives(xs, values, first, second, count);
+  }
+}
+
+std::vector<double> CalculatorModel::FindRoots(const std::string &input,
+                                               double low_x, double high_x) {
+  UpdateRpn(input);
+  return RootFinder(*expression_, pool_.get()).FindRoots(low_x, high_x);
+}
 
-  return std::pair<std::vector<double>, std::vector<double>>(xv, yv);
+std::vector<Extremum> CalculatorModel::FindExtrema(const std::string &input,
+                                                   double low_x,
+                                                   double high_x) {
+  UpdateRpn(input);
+  return RootFinder(*expression_, pool_.get()).FindExtrema(low_x, high_x);
+}
+
+Integral CalculatorModel::Integrate(const std::string &input, double low_x,
+                                    double high_x,
+                                    const IntegrationOptions &options) {
+  UpdateRpn(input);
+  Integral integral =
+      Integrator(*expression_, pool_.get(), options).Integrate(low_x, high_x);
+  evaluations_ = integral.evaluations;
+  return integral;
+}
+
+void CalculatorModel::EnableNativeCode(bool enable) {
+  if (enable != native_enabled_) {
+    native_enabled_ = enable;
+    expression_.reset();
+    input_.clear();
+  }
+}
+
+bool CalculatorModel::isUsingNativeCode() const noexcept {
+  return expression_ && expression_->isUsingNativeCode();
+}
+
+void CalculatorModel::EnableParallelSampling(bool enable, size_t threads,
+                                             size_t grain) {
+  pool_.reset();
+  if (enable) {
+    pool_ = std::make_shared<ThreadPool>(threads);
+  }
+  grain_ = grain;
+}
+
+size_t CalculatorModel::SamplingThreads() const noexcept {
+  return pool_ ? pool_->ThreadCount() : 1;
+}
+
+void CalculatorModel::ShareSamplingPool(std::shared_ptr<ThreadPool> pool,
+                                        size_t grain) {
+  pool_ = std::move(pool);
+  grain_ = grain;
+}
+
+std::shared_ptr<ThreadPool> CalculatorModel::SamplingPool() const noexcept {
+  return pool_;
+}
+
+void CalculatorModel::ShareExpressionCache(
+    std::shared_ptr<ExpressionCache> cache) {
+  cache_ = std::move(cache);
+  expression_.reset();
+  input_.clear();
+}
+
+std::shared_ptr<ExpressionCache> CalculatorModel::Cache() const noexcept {
+  return cache_;
 }
 
 void CalculatorModel::UpdateRpn(const std::string &input) {
-  size_t hash = std::hash<std::string>{}(input);
+  ParseStatus status = TryUpdateRpn(input);
+  ThrowError(status.code, status.position);
+}
 
-  if (hash != old_hash_) {
-    rpn_.clear();
-    std::vector<Lexeme> parsed = Parse(input);
-    ShuntingYard(parsed);
-    old_hash_ = hash;
+ParseStatus CalculatorModel::TryUpdateRpn(const std::string &input) {
+  if (expression_ && input == input_) {
+    return ParseStatus();
   }
+  expression_.reset();
+  input_.clear();
+  ParseStatus status;
+  expression_ = cache_->Get(
+      input, native_enabled_, [&]() -> ExpressionCache::Entry {
+        auto compiled = std::make_shared<CompiledExpression>();
+        status = TryCompile(input, *compiled, native_enabled_);
+        if (!status.isOk()) {
+          return nullptr;
+        }
+        return compiled;
+      });
+  if (expression_) {
+    input_ = input;
+  }
+  return status;
+}
+
+ParseStatus CalculatorModel::Prepare(const std::string &input) {
+  return TryUpdateRpn(input);
 }
 
-std::vector<Lexeme> CalculatorModel::Parse(const std::string &input) {
+ParseStatus CalculatorModel::PrepareEdit(const std::string &input,
+                                         bool &changed) {
+  changed = true;
+  Relex(input);
+  std::vector<Lexeme> lexemes;
+  lexemes.reserve(tokens_.size());
+  for (const Token &token : tokens_) {
+    if (token.error != NO_ERROR) {
+      return {token.error, token.begin};
+    }
+    lexemes.push_back(token.lexeme);
+  }
+  ContextDepententParse(lexemes);
+  CompiledExpression translated;
+  ParseStatus status = Translate(lexemes, translated);
+  if (!status.isOk()) {
+    return status;
+  }
+
+  if (expression_ &&
+      std::equal(translated.rpn_.begin(), translated.rpn_.end(),
+                 expression_->rpn_.begin(), expression_->rpn_.end(),
+                 [](const Lexeme &a, const Lexeme &b) {
+                   return a.type == b.type && a.num == b.num;
+                 })) {
+    changed = false;
+    input_ = input;
+    return status;
+  }
+  expression_ = cache_->Get(
+      input, native_enabled_, [&]() -> ExpressionCache::Entry {
+        Finish(translated, input, native_enabled_);
+        return std::make_shared<const CompiledExpression>(
+            std::move(translated));
+      });
+  input_ = input;
+  return status;
+}
+
+size_t CalculatorModel::LastRelexedLength() const noexcept {
+  return relexed_;
+}
+
+CompiledExpression CalculatorModel::Compile(const std::string &input,
+                                            bool native_code) const {
+  CompiledExpression out;
+  ParseStatus status = TryCompile(input, out, native_code);
+  ThrowError(status.code, status.position);
+  return out;
+}
+
+ParseStatus CalculatorModel::TryCompile(std::string_view input,
+                                        CompiledExpression &out,
+                                        bool native_code) const {
+  std::vector<Lexeme> parsed;
+  ParseStatus status = Parse(input, parsed);
+  CompiledExpression compiled;
+  if (status.isOk()) {
+    status = Translate(parsed, compiled);
+  }
+  if (status.isOk()) {
+    Finish(compiled, input, native_code);
+    out = std::move(compiled);
+  }
+  return status;
+}
+
+// RPN and the unoptimized program of the lexemes.
+ParseStatus CalculatorModel::Translate(const std::vector<Lexeme> &lexemes,
+                                       CompiledExpression &out) const {
+  ParseStatus status = ShuntingYard(lexemes, out);
+  if (status.isOk() && !out.program_.isComplete()) {
+    status.code = MORE_NUMBERS_THAN_EXPECTED;
+  }
+  return status;
+}
+
+void CalculatorModel::Finish(CompiledExpression &expression,
+                             std::string_view input, bool native_code) const {
+  expression.program_ =
+      expression.program_.FoldConstants().EliminateCommonSubexpressions();
+  expression.jit_ = std::make_shared<const JitProgram>(expression.program_);
+  if (native_code) {
+    expression.native_ = std::make_shared<const NativeProgram>(
+        expression.program_, std::string(input));
+  }
+}
+
+std::vector<Lexeme> CalculatorModel::Tokenize(const std::string &input) const {
   std::vector<Lexeme> result;
+  ParseStatus status = Parse(input, result);
+  ThrowError(status.code, status.position);
+  return result;
+}
 
-  for (auto cur = input.data(); *cur;) {
-    if (std::isspace(*cur)) {
-      ++cur;
+ParseStatus CalculatorModel::Parse(std::string_view input,
+                                   std::vector<Lexeme> &result) const {
+  ParseStatus status;
+
+  for (size_t pos = 0; pos < input.size() && status.isOk();) {
+    Lexeme lexeme;
+    if (std::isspace(static_cast<unsigned char>(input[pos]))) {
+      ++pos;
       continue;
-    } else if (*cur == '.' || isdigit(*cur)) {
-      Lexeme number_lexeme = ParseNumber(cur, input.data());
-      result.push_back(number_lexeme);
+    } else if (input[pos] == '.' || isdigit(input[pos])) {
+      status = ParseNumber(input, pos, lexeme);
     } else {
-      Lexeme type_lexeme = ParseType(cur, input.data());
-      result.push_back(type_lexeme);
+      status = ParseType(input, pos, lexeme);
+    }
+    if (status.isOk()) {
+      result.push_back(lexeme);
     }
   }
 
   ContextDepententParse(result);
 
-  return result;
+  return status;
 }
 
-Lexeme CalculatorModel::ParseNumber(
-    const std::string::value_type *&cur,
-    const std::string::value_type *input_begin) {
-  std::string::size_type off = 0;
+ParseStatus CalculatorModel::ParseNumber(std::string_view input, size_t &pos,
+                                         Lexeme &lexeme) const {
   double num = 0;
-  try {
-    num = std::stod(cur, &off);
-  } catch (std::invalid_argument &e) {
-    ThrowError(INCORRECT_NUMBER, cur - input_begin);
-  }
-  cur += off;
-  Lexeme number_lexeme = kLexemeProperties[Lexeme::NUM];
-  number_lexeme.num = num;
-  return number_lexeme;
-}
-
-Lexeme CalculatorModel::ParseType(const std::string::value_type *&cur,
-                                  const std::string::value_type *input_begin) {
-  auto it = kStringToLexeme.begin();
-  for (; it != kStringToLexeme.end(); ++it) {
-    if (!strncmp(cur, it->first.data(), it->first.length())) {
-      cur += it->first.length();
-      return kLexemeProperties[it->second];
+  const char *end = input.data() + input.size();
+  std::from_chars_result parsed =
+      std::from_chars(input.data() + pos, end, num);
+  if (parsed.ec != std::errc()) {
+    return {INCORRECT_NUMBER, pos};
+  }
+  pos = parsed.ptr - input.data();
+  lexeme = kLexemeProperties[Lexeme::NUM];
+  lexeme.num = num;
+  return ParseStatus();
+}
+
+ParseStatus CalculatorModel::ParseType(std::string_view input, size_t &pos,
+                                       Lexeme &lexeme) const {
+  Lexeme::Type type = Lexeme::NO_TYPE;
+  size_t length = kLexemeTrie.Match(input.substr(pos), type);
+  if (!length) {
+    return {INCORRECT_LEXEME, pos};
+  }
+  pos += length;
+  lexeme = kLexemeProperties[type];
+  return ParseStatus();
+}
+
+CalculatorModel::Token CalculatorModel::LexToken(std::string_view input,
+                                                 size_t pos) const {
+  Token token;
+  token.begin = token.end = pos;
+  ParseStatus status = input[pos] == '.' || isdigit(input[pos])
+                           ? ParseNumber(input, token.end, token.lexeme)
+                           : ParseType(input, token.end, token.lexeme);
+  if (!status.isOk()) {
+    token.error = status.code;
+    token.end = pos + 1;
+  }
+  return token;
+}
+
+// Lexing from a token start depends only on the text after it, so tokens
+// before the edit are kept and lexing stops at the first token start past
+// the edit where the previous input had one too; the tokens from there on
+// are the old ones shifted by the change in length.
+void CalculatorModel::Relex(std::string_view input) {
+  std::string_view old = text_;
+  size_t prefix = 0;
+  while (prefix < old.size() && prefix < input.size() &&
+         old[prefix] == input[prefix]) {
+    ++prefix;
+  }
+  size_t suffix = 0;
+  while (suffix < old.size() - prefix && suffix < input.size() - prefix &&
+         old[old.size() - 1 - suffix] == input[input.size() - 1 - suffix]) {
+    ++suffix;
+  }
+
+  size_t first = std::partition_point(tokens_.begin(), tokens_.end(),
+                                      [prefix](const Token &token) {
+                                        return token.end + kLookahead < prefix;
+                                      }) -
+                 tokens_.begin();
+  size_t start = first < tokens_.size() ? std::min(tokens_[first].begin, prefix)
+                                        : prefix;
+  size_t edited_end = input.size() - suffix;
+  size_t resume = first;
+  std::vector<Token> relexed;
+  size_t pos = start;
+  while (true) {
+    while (pos < input.size() &&
+           std::isspace(static_cast<unsigned char>(input[pos]))) {
+      ++pos;
     }
+    if (pos == input.size()) {
+      resume = tokens_.size();
+      break;
+    } else if (pos >= edited_end) {
+      size_t old_pos = pos + old.size() - input.size();
+      while (resume < tokens_.size() && tokens_[resume].begin < old_pos) {
+        ++resume;
+      }
+      if (resume < tokens_.size() && tokens_[resume].begin == old_pos) {
+        break;
+      }
+    }
+    relexed.push_back(LexToken(input, pos));
+    pos = relexed.back().end;
   }
-  if (it == kStringToLexeme.end()) {
-    ThrowError(INCORRECT_LEXEME, cur - input_begin);
+  relexed_ = pos - start;
+
+  tokens_.erase(tokens_.begin() + first, tokens_.begin() + resume);
+  tokens_.insert(tokens_.begin() + first, relexed.begin(), relexed.end());
+  for (size_t i = first + relexed.size(); i < tokens_.size(); ++i) {
+    tokens_[i].begin += input.size() - old.size();
+    tokens_[i].end += input.size() - old.size();
   }
-  return Lexeme{};
+  text_.assign(input);
 }
 
 void CalculatorModel::ContextDepententParse(
-    std::vector<Lexeme> &parsed_string) {
+    std::vector<Lexeme> &parsed_string) const {
   if (parsed_string.size() <= 1) return;
   for (auto prev = parsed_string.begin(), it = prev + 1;
        it != parsed_string.end(); prev = it, ++it) {
@@ -121,96 +477,123 @@ void CalculatorModel::ContextDepententParse(
   }
 }
 
-void CalculatorModel::ShuntingYard(const std::vector<Lexeme> &input) {
+ParseStatus CalculatorModel::ShuntingYard(const std::vector<Lexeme> &input,
+                                          CompiledExpression &out) const {
   std::stack<Lexeme> stack;
+  ParseStatus status;
 
-  for (auto lex = input.begin(); lex != input.end(); ++lex) {
+  for (auto lex = input.begin(); lex != input.end() && status.isOk(); ++lex) {
     if (lex->isNumber()) {
-      rpn_.push_back(*lex);
+      status = Emit(*lex, out);
     } else if (lex->isFunction() || lex->type == Lexeme::LEFTPAR) {
       stack.push(*lex);
     } else if (lex->isOperator()) {
-      ShuntingYardOperatorCase(stack, *lex);
+      status = ShuntingYardOperatorCase(stack, *lex, out);
     } else if (lex->type == Lexeme::RIGHTPAR) {
-      ShuntingYardRightParenthesisCase(stack, lex - input.begin());
+      status =
+          ShuntingYardRightParenthesisCase(stack, lex - input.begin(), out);
     }
   }
-  ShuntingYardEmptyStack(stack);
+  if (!status.isOk()) {
+    return status;
+  }
+  return ShuntingYardEmptyStack(stack, out);
 }
 
-void CalculatorModel::ShuntingYardOperatorCase(std::stack<Lexeme> &stack,
-                                               const Lexeme lexeme) {
+ParseStatus CalculatorModel::ShuntingYardOperatorCase(
+    std::stack<Lexeme> &stack, const Lexeme lexeme,
+    CompiledExpression &out) const {
   while (!stack.empty() && stack.top().isOperator() &&
          (stack.top().priority > lexeme.priority ||
           (stack.top().priority == lexeme.priority &&
            lexeme.assoc == Lexeme::ASSOC_LEFT))) {
-    rpn_.push_back(stack.top());
+    ParseStatus status = Emit(stack.top(), out);
+    if (!status.isOk()) {
+      return status;
+    }
     stack.pop();
   }
   stack.push(lexeme);
+  return ParseStatus();
 }
 
-void CalculatorModel::ShuntingYardRightParenthesisCase(
-    std::stack<Lexeme> &stack, size_t right_parent_offset) {
+ParseStatus CalculatorModel::ShuntingYardRightParenthesisCase(
+    std::stack<Lexeme> &stack, size_t right_parent_offset,
+    CompiledExpression &out) const {
   while (!stack.empty() && stack.top().type != Lexeme::LEFTPAR) {
-    rpn_.push_back(stack.top());
+    ParseStatus status = Emit(stack.top(), out);
+    if (!status.isOk()) {
+      return status;
+    }
     stack.pop();
   }
   if (!stack.empty() && stack.top().type == Lexeme::LEFTPAR) {
     stack.pop();
   } else {
-    ThrowError(UNOPENED_PARENT, right_parent_offset);
+    return {UNOPENED_PARENT, right_parent_offset};
   }
   if (!stack.empty() && stack.top().isFunction()) {
-    rpn_.push_back(stack.top());
+    ParseStatus status = Emit(stack.top(), out);
+    if (!status.isOk()) {
+      return status;
+    }
     stack.pop();
   }
+  return ParseStatus();
 }
 
-void CalculatorModel::ShuntingYardEmptyStack(std::stack<Lexeme> &stack) {
+ParseStatus CalculatorModel::ShuntingYardEmptyStack(
+    std::stack<Lexeme> &stack, CompiledExpression &out) const {
   while (!stack.empty()) {
     if (stack.top().type == Lexeme::LEFTPAR) {
-      ThrowError(UNCLOSED_PARENT);
+      return {UNCLOSED_PARENT};
     }
-    rpn_.push_back(stack.top());
-    stack.pop();
-  }
-}
-
-double CalculatorModel::Solve(double x) const {
-  if (rpn_.empty()) return 0;
-  std::stack<double> numstack;
-
-  for (auto lex : rpn_) {
-    if (lex.isVar()) {
-      numstack.push(x);
-    } else if (lex.isNumber()) {
-      numstack.push(lex.num);
-    } else if (lex.isFunction() || lex.isOperator()) {
-      if (numstack.size() < lex.operandCount) {
-        ThrowError(NOT_ENOUGH_OPERANDS);
-      }
-      std::vector<double> operands(lex.operandCount);
-      for (size_t i = 0; i < lex.operandCount; ++i) {
-        operands[lex.operandCount - i - 1] = numstack.top();
-        numstack.pop();
-      }
-      numstack.push(Apply(lex, operands));
+    ParseStatus status = Emit(stack.top(), out);
+    if (!status.isOk()) {
+      return status;
     }
+    stack.pop();
   }
-
-  if (numstack.size() > 1) {
-    ThrowError(MORE_NUMBERS_THAN_EXPECTED);
+  return ParseStatus();
+}
+
+ParseStatus CalculatorModel::Emit(const Lexeme &lex,
+                                  CompiledExpression &out) const {
+  out.rpn_.push_back(lex);
+  if (lex.isVar()) {
+    out.program_.PushX();
+  } else if (lex.isNumber()) {
+    out.program_.PushConstant(lex.num);
+  } else if (!out.program_.Apply(lex.opcode)) {
+    return {NOT_ENOUGH_OPERANDS};
   }
-  return numstack.top();
-}
-
-double CalculatorModel::Apply(const Lexeme lex,
-                              const std::vector<double> &operands) const {
-  if (!lex.solver) {
-    ThrowError(UNIMPLEMENTED_SOLVER_CALLED);
+  return ParseStatus();
+}
+
+CompiledExpression Compile(const std::string &input, bool native_code) {
+  CompiledExpression out;
+  ParseStatus status = TryCompile(input, out, native_code);
+  ThrowError(status.code, status.position);
+  return out;
+}
+
+ParseStatus TryCompile(std::string_view input, CompiledExpression &out,
+                       bool native_code) {
+  static const CalculatorModel compiler;
+  ParseStatus status;
+  ExpressionCache::Entry expression = ExpressionCache::Shared()->Get(
+      input, native_code, [&]() -> ExpressionCache::Entry {
+        auto compiled = std::make_shared<CompiledExpression>();
+        status = compiler.TryCompile(input, *compiled, native_code);
+        if (!status.isOk()) {
+          return nullptr;
+        }
+        return compiled;
+      });
+  if (expression) {
+    out = *expression;
   }
-  return lex.solver(operands);
+  return status;
 }
 
 double CalculatorModel::Solver::uplus(
@@ -303,35 +686,4 @@ double CalculatorModel::Solver::log(
   return ::log(operands[0]) / ::log(10);
 }
 
-void CalculatorModel::ThrowError(enum ErrorCode code, size_t position) const {
-  if (code == INCORRECT_LEXEME) {
-    throw std::invalid_argument(std::string("Incorrect Lexeme Type at char ") +
-                                std::to_string(position));
-  } else if (code == INCORRECT_NUMBER) {
-    throw std::invalid_argument(std::string("Incorrect Number Value at char ") +
-                                std::to_string(position));
-  } else if (code == UNCLOSED_PARENT) {
-    throw std::invalid_argument(
-        std::string("Found parenthesis (unclosed) without a pair"));
-  } else if (code == UNOPENED_PARENT) {
-    throw std::invalid_argument(
-        std::string("Found parenthesis (unopened) without a pair at lexem #") +
-        std::to_string(position + 1));
-  } else if (code == NOT_ENOUGH_OPERANDS) {
-    throw std::invalid_argument(
-        std::string("Some operator/function had not enough operands"));
-  } else if (code == MORE_NUMBERS_THAN_EXPECTED) {
-    throw std::invalid_argument(
-        std::string("Found two or more numbers in a row without an operator"));
-  } else if (code == UNIMPLEMENTED_SOLVER_CALLED) {
-    throw std::invalid_argument(
-        std::string("Operator that wasn't implemented can't be applied"));
-  }
-}
-
-bool Lexeme::isNumber() const noexcept { return ftype == NUMBER; }
-bool Lexeme::isVar() const noexcept { return type == XNUM; }
-bool Lexeme::isFunction() const noexcept { return ftype == FUNCTION; }
-bool Lexeme::isOperator() const noexcept { return ftype == OPERATOR; }
-
 };  // namespace s21
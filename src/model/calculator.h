@@ -1,102 +1,145 @@
 #ifndef SMARTCALC_MODEL_CALCULATOR_H_
 #define SMARTCALC_MODEL_CALCULATOR_H_
 
+#include <array>
+#include <memory>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <vector>
 
-namespace s21 {
-
-enum ErrorCode {
-  INCORRECT_LEXEME,
-  INCORRECT_NUMBER,
-  UNCLOSED_PARENT,
-  UNOPENED_PARENT,
-  NOT_ENOUGH_OPERANDS,
-  MORE_NUMBERS_THAN_EXPECTED,
-  UNIMPLEMENTED_SOLVER_CALLED,
-};
-
-struct Lexeme {
-  enum Type {
-    NO_TYPE,
-    UPLUS,
-    UMINUS,
-    ADD,
-    SUB,
-    XNUM,
-    NUM,
-    POW,
-    MUL,
-    DIV,
-    MOD,
-    LEFTPAR,
-    RIGHTPAR,
-    COS,
-    SIN,
-    TAN,
-    COTAN,
-    ACOS,
-    ASIN,
-    ATAN,
-    SQRT,
-    LN,
-    LOG,
-    END,
-  };
-  enum Associativity { NO_ASSOC, ASSOC_LEFT, ASSOC_RIGHT };
-  enum FundamentalType {
-    NO_FUNDAMENTAL_TYPE,
-    NUMBER,
-    FUNCTION,
-    OPERATOR,
-    PARENTHESIS,
-  };
+#include "expression.h"
+#include "expression_cache.h"
+#include "integrator.h"
+#include "lexeme.h"
+#include "roots.h"
+#include "sampler.h"
+#include "trie.h"
 
-  enum Type type = NO_TYPE;
-  size_t priority = -1;
-  double num = 0;
-  size_t operandCount = 0;
-  enum Associativity assoc = NO_ASSOC;
-  enum FundamentalType ftype = NO_FUNDAMENTAL_TYPE;
-  double (*solver)(const std::vector<double> &);
-
-  bool isNumber() const noexcept;
-  bool isVar() const noexcept;
-  bool isFunction() const noexcept;
-  bool isOperator() const noexcept;
-};
+namespace s21 {
 
 class CalculatorModel {
  public:
   bool isContainingX(const std::string &input);
   double Calculate(const std::string &input, double x = 0);
+  double CalculateReference(const std::string &input, double x = 0);
   std::pair<std::vector<double>, std::vector<double>> Calculate(
       const std::string &input, double low_x, double high_x, double low_y,
       double high_y, size_t points);
+  std::pair<std::vector<double>, std::vector<double>> CalculateAdaptive(
+      const std::string &input, double low_x, double high_x, double low_y,
+      double high_y, const SamplingOptions &options = {});
+  size_t LastEvaluationCount() const noexcept;
+  // Union of the interval enclosures of pieces equal parts of the range,
+  // leaving out unbounded ones (poles): a y range for the plot found without
+  // sampling. Empty when no part is bounded.
+  static constexpr size_t kRangePieces = 64;
+  Interval EstimateRange(const std::string &input, double low_x,
+                         double high_x, size_t pieces = kRangePieces);
+  void EvaluateBatch(const std::string &input, const double *xs, double *out,
+                     size_t count);
+  // Values with exact first and second derivatives; first or second may be
+  // null.
+  void EvaluateDerivatives(const std::string &input, const double *xs,
+                           double *values, double *first, double *second,
+                           size_t count);
+  std::vector<double> FindRoots(const std::string &input, double low_x,
+                                double high_x);
+  std::vector<Extremum> FindExtrema(const std::string &input, double low_x,
+                                    double high_x);
+  Integral Integrate(const std::string &input, double low_x, double high_x,
+                     const IntegrationOptions &options = {});
+  void EnableNativeCode(bool enable);
+  bool isUsingNativeCode() const noexcept;
+
+  // Splits range sampling into grain-sized chunks over a work-stealing pool
+  // of threads workers (0: one per core). The output does not depend on it.
+  static constexpr size_t kSamplingGrain = 16384;
+  void EnableParallelSampling(bool enable, size_t threads = 0,
+                              size_t grain = kSamplingGrain);
+  size_t SamplingThreads() const noexcept;
+  // Samples on pool, which other models may be using at the same time; null
+  // samples on the calling thread.
+  void ShareSamplingPool(std::shared_ptr<ThreadPool> pool,
+                         size_t grain = kSamplingGrain);
+  std::shared_ptr<ThreadPool> SamplingPool() const noexcept;
+
+  // Compiled expressions come from this cache, ExpressionCache::Shared()
+  // unless replaced.
+  void ShareExpressionCache(std::shared_ptr<ExpressionCache> cache);
+  std::shared_ptr<ExpressionCache> Cache() const noexcept;
+
+  CompiledExpression Compile(const std::string &input,
+                             bool native_code = false) const;
+  // Compile without exceptions for malformed input: the status says what is
+  // wrong and where, and out is only assigned on success.
+  ParseStatus TryCompile(std::string_view input, CompiledExpression &out,
+                         bool native_code = false) const;
+  // Compiles input for the calls that follow, reporting malformed input
+  // instead of throwing, so callers can skip it cheaply.
+  ParseStatus Prepare(const std::string &input);
+  // Prepare for input edited in place, as typed into the line edit: only the
+  // span that differs from the previous call's input is lexed again, and
+  // nothing is recompiled when the lexemes come out the same. changed tells
+  // whether the expression differs from the one compiled before.
+  ParseStatus PrepareEdit(const std::string &input, bool &changed);
+  size_t LastRelexedLength() const noexcept;
+  // Lexemes of input with unary signs resolved, without compiling it.
+  std::vector<Lexeme> Tokenize(const std::string &input) const;
 
  private:
-  void UpdateRpn(const std::string &input);
-
-  std::vector<Lexeme> Parse(const std::string &input);
-  Lexeme ParseNumber(const std::string::value_type *&cur,
-                     const std::string::value_type *input_begin);
-  Lexeme ParseType(const std::string::value_type *&cur,
-                   const std::string::value_type *input_begin);
-  void ContextDepententParse(std::vector<Lexeme> &parsed_string);
-  size_t old_hash_ = 0;
-
-  void ShuntingYard(const std::vector<Lexeme> &input);
-  void ShuntingYardOperatorCase(std::stack<Lexeme> &stack, const Lexeme lex);
-  void ShuntingYardRightParenthesisCase(std::stack<Lexeme> &stack,
-                                        size_t right_parent_offset);
-  void ShuntingYardEmptyStack(std::stack<Lexeme> &stack);
-  std::vector<Lexeme> rpn_;
-
-  double Solve(double x) const;
-  double Apply(const Lexeme lexeme, const std::vector<double> &operands) const;
+  static constexpr size_t kCullBlock = 256;
+  // How far past its end lexing a token may have read: the longest name, or
+  // an exponent marker and its sign.
+  static constexpr size_t kLookahead = 8;
+
+  // A lexeme with its span in the input; malformed spans are kept as error
+  // tokens so that lexing can go on past them.
+  struct Token {
+    Lexeme lexeme;
+    size_t begin = 0;
+    size_t end = 0;
+    enum ErrorCode error = NO_ERROR;
+  };
 
-  void ThrowError(enum ErrorCode code, size_t position = 0) const;
+  void UpdateRpn(const std::string &input);
+  ParseStatus TryUpdateRpn(const std::string &input);
+  std::shared_ptr<ExpressionCache> cache_ = ExpressionCache::Shared();
+  ExpressionCache::Entry expression_;
+  std::string input_;
+  bool native_enabled_ = false;
+  std::shared_ptr<ThreadPool> pool_;
+  size_t grain_ = kSamplingGrain;
+  size_t evaluations_ = 0;
+  std::string text_;
+  std::vector<Token> tokens_;
+  size_t relexed_ = 0;
+
+  ParseStatus Parse(std::string_view input,
+                    std::vector<Lexeme> &result) const;
+  ParseStatus ParseNumber(std::string_view input, size_t &pos,
+                          Lexeme &lexeme) const;
+  ParseStatus ParseType(std::string_view input, size_t &pos,
+                        Lexeme &lexeme) const;
+  void ContextDepententParse(std::vector<Lexeme> &parsed_string) const;
+  Token LexToken(std::string_view input, size_t pos) const;
+  void Relex(std::string_view input);
+  ParseStatus Translate(const std::vector<Lexeme> &lexemes,
+                        CompiledExpression &out) const;
+  void Finish(CompiledExpression &expression, std::string_view input,
+              bool native_code) const;
+
+  ParseStatus ShuntingYard(const std::vector<Lexeme> &input,
+                           CompiledExpression &out) const;
+  ParseStatus ShuntingYardOperatorCase(std::stack<Lexeme> &stack,
+                                       const Lexeme lex,
+                                       CompiledExpression &out) const;
+  ParseStatus ShuntingYardRightParenthesisCase(std::stack<Lexeme> &stack,
+                                               size_t right_parent_offset,
+                                               CompiledExpression &out) const;
+  ParseStatus ShuntingYardEmptyStack(std::stack<Lexeme> &stack,
+                                     CompiledExpression &out) const;
+  ParseStatus Emit(const Lexeme &lex, CompiledExpression &out) const;
 
   class Solver {
    public:
@@ -120,7 +163,8 @@ class CalculatorModel {
     static double log(const std::vector<double> &operands) noexcept;
   };
 
-  const std::vector<std::pair<std::string, Lexeme::Type>> kStringToLexeme{
+  using LexemeTrie = StaticTrie<Lexeme::Type, 64>;
+  static constexpr std::array<LexemeTrie::Word, 23> kStringToLexeme{{
       {"+", Lexeme::UPLUS},   {"-", Lexeme::UMINUS},   {"x", Lexeme::XNUM},
       {"X", Lexeme::XNUM},    {"^", Lexeme::POW},      {"*", Lexeme::MUL},
       {"/", Lexeme::DIV},     {"%", Lexeme::MOD},      {"mod", Lexeme::MOD},
@@ -129,48 +173,54 @@ class CalculatorModel {
       {"tg", Lexeme::TAN},    {"tan", Lexeme::TAN},    {"acos", Lexeme::ACOS},
       {"asin", Lexeme::ASIN}, {"atan", Lexeme::ATAN},  {"sqrt", Lexeme::SQRT},
       {"ln", Lexeme::LN},     {"log", Lexeme::LOG},
-  };
+  }};
+  static constexpr LexemeTrie kLexemeTrie{kStringToLexeme};
 
   const Lexeme kLexemeProperties[Lexeme::END]{
       {Lexeme::NO_TYPE, 0, 0, 0, Lexeme::NO_ASSOC, Lexeme::NO_FUNDAMENTAL_TYPE,
        nullptr},
       {Lexeme::UPLUS, 3, 0, 1, Lexeme::ASSOC_LEFT, Lexeme::OPERATOR,
-       &Solver::uplus},
+       &Solver::uplus, Instruction::NOP},
       {Lexeme::UMINUS, 3, 0, 1, Lexeme::ASSOC_LEFT, Lexeme::OPERATOR,
-       &Solver::uminus},
+       &Solver::uminus, Instruction::NEG},
       {Lexeme::ADD, 1, 0, 2, Lexeme::ASSOC_LEFT, Lexeme::OPERATOR,
-       &Solver::add},
+       &Solver::add, Instruction::ADD},
       {Lexeme::SUB, 1, 0, 2, Lexeme::ASSOC_LEFT, Lexeme::OPERATOR,
-       &Solver::sub},
+       &Solver::sub, Instruction::SUB},
       {Lexeme::XNUM, 0, 0, 0, Lexeme::NO_ASSOC, Lexeme::NUMBER, nullptr},
       {Lexeme::NUM, 0, 0, 0, Lexeme::NO_ASSOC, Lexeme::NUMBER, nullptr},
       {Lexeme::POW, 4, 0, 2, Lexeme::ASSOC_RIGHT, Lexeme::OPERATOR,
-       &Solver::pow},
+       &Solver::pow, Instruction::POW},
       {Lexeme::MUL, 2, 0, 2, Lexeme::ASSOC_LEFT, Lexeme::OPERATOR,
-       &Solver::mul},
+       &Solver::mul, Instruction::MUL},
       {Lexeme::DIV, 2, 0, 2, Lexeme::ASSOC_LEFT, Lexeme::OPERATOR,
-       &Solver::div},
+       &Solver::div, Instruction::DIV},
       {Lexeme::MOD, 2, 0, 2, Lexeme::ASSOC_LEFT, Lexeme::OPERATOR,
-       &Solver::mod},
+       &Solver::mod, Instruction::MOD},
       {Lexeme::LEFTPAR, 0, 0, 0, Lexeme::NO_ASSOC, Lexeme::PARENTHESIS,
        nullptr},
       {Lexeme::RIGHTPAR, 0, 0, 0, Lexeme::NO_ASSOC, Lexeme::PARENTHESIS,
        nullptr},
-      {Lexeme::COS, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION, &Solver::cos},
-      {Lexeme::SIN, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION, &Solver::sin},
-      {Lexeme::TAN, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION, &Solver::tan},
+      {Lexeme::COS, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
+       &Solver::cos, Instruction::COS},
+      {Lexeme::SIN, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
+       &Solver::sin, Instruction::SIN},
+      {Lexeme::TAN, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
+       &Solver::tan, Instruction::TAN},
       {Lexeme::COTAN, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
-       &Solver::cotan},
+       &Solver::cotan, Instruction::COTAN},
       {Lexeme::ACOS, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
-       &Solver::acos},
+       &Solver::acos, Instruction::ACOS},
       {Lexeme::ASIN, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
-       &Solver::asin},
+       &Solver::asin, Instruction::ASIN},
       {Lexeme::ATAN, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
-       &Solver::atan},
+       &Solver::atan, Instruction::ATAN},
       {Lexeme::SQRT, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
-       &Solver::sqrt},
-      {Lexeme::LN, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION, &Solver::ln},
-      {Lexeme::LOG, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION, &Solver::log},
+       &Solver::sqrt, Instruction::SQRT},
+      {Lexeme::LN, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
+       &Solver::ln, Instruction::LN},
+      {Lexeme::LOG, 0, 0, 1, Lexeme::NO_ASSOC, Lexeme::FUNCTION,
+       &Solver::log, Instruction::LOG},
   };
 };
 
@@ -0,0 +1,114 @@
+#include "dag.h"
+
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+ExpressionDag::ExpressionDag(const Program &program) {
+  std::vector<uint32_t> slot_node(program.SlotCount());
+  for (const Instruction &ins : program.Code()) {
+    uint32_t node;
+    if (ins.op == Instruction::LOAD_X) {
+      node = Intern(ins.op, 0, 0, 0);
+    } else if (ins.op == Instruction::LOAD_CONST) {
+      node = Intern(ins.op, 0, 0, program.Constants()[ins.a]);
+    } else if (ins.isBinary()) {
+      node = Intern(ins.op, slot_node[ins.a], slot_node[ins.b], 0);
+    } else {
+      node = Intern(ins.op, slot_node[ins.a], 0, 0);
+    }
+    slot_node[ins.dst] = node;
+  }
+  if (!program.isEmpty()) {
+    root_ = slot_node[program.Result()];
+  }
+}
+
+const std::vector<ExpressionDag::Node> &ExpressionDag::Nodes() const noexcept {
+  return nodes_;
+}
+
+bool ExpressionDag::isEmpty() const noexcept { return nodes_.empty(); }
+uint32_t ExpressionDag::Root() const noexcept { return root_; }
+
+// Every node is computed once, in topological order. A slot returns to the
+// free list right after the last reader of its node, so the next result can
+// reuse it (kernels allow the output to alias an input).
+Program ExpressionDag::Schedule() const {
+  Program program;
+  if (nodes_.empty()) {
+    return program;
+  }
+
+  std::vector<uint32_t> last_use(nodes_.size(), 0);
+  for (uint32_t i = 0; i <= root_; ++i) {
+    size_t arity = Instruction::Arity(nodes_[i].op);
+    if (arity >= 1) last_use[nodes_[i].a] = i;
+    if (arity == 2) last_use[nodes_[i].b] = i;
+  }
+
+  std::vector<uint32_t> slot(nodes_.size());
+  std::vector<uint32_t> free_slots;
+  uint32_t slot_count = 0;
+  auto release = [&](uint32_t operand, uint32_t reader) {
+    if (last_use[operand] == reader) {
+      free_slots.push_back(slot[operand]);
+    }
+  };
+
+  for (uint32_t i = 0; i <= root_; ++i) {
+    const Node &node = nodes_[i];
+    Instruction ins{node.op, 0, 0, 0};
+    size_t arity = Instruction::Arity(node.op);
+    if (node.op == Instruction::LOAD_CONST) {
+      ins.a = program.AddConstant(node.value);
+    }
+    if (arity >= 1) ins.a = slot[node.a];
+    if (arity == 2) ins.b = slot[node.b];
+    if (arity >= 1) release(node.a, i);
+    if (arity == 2 && node.b != node.a) release(node.b, i);
+    if (free_slots.empty()) {
+      slot[i] = slot_count++;
+    } else {
+      slot[i] = free_slots.back();
+      free_slots.pop_back();
+    }
+    ins.dst = slot[i];
+    program.Append(ins);
+  }
+  program.SetResult(slot[root_]);
+  return program;
+}
+
+uint32_t ExpressionDag::Intern(Instruction::OpCode op, uint32_t a, uint32_t b,
+                               double value) {
+  if ((op == Instruction::ADD || op == Instruction::MUL) && a > b) {
+    std::swap(a, b);
+  }
+  Key key{op, a, b, 0};
+  std::memcpy(&key.bits, &value, sizeof(value));
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    return it->second;
+  }
+  uint32_t node = nodes_.size();
+  nodes_.push_back({op, a, b, value});
+  index_.emplace(key, node);
+  return node;
+}
+
+bool ExpressionDag::Key::operator==(const Key &other) const noexcept {
+  return op == other.op && a == other.a && b == other.b && bits == other.bits;
+}
+
+size_t ExpressionDag::KeyHash::operator()(const Key &key) const noexcept {
+  size_t hash = std::hash<uint64_t>{}(key.bits);
+  hash = hash * 31 + key.op;
+  hash = hash * 31 + key.a;
+  return hash * 31 + key.b;
+}
+
+};  // namespace s21
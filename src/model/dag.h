@@ -0,0 +1,56 @@
+#ifndef SMARTCALC_MODEL_DAG_H_
+#define SMARTCALC_MODEL_DAG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "program.h"
+
+namespace s21 {
+
+// Hash-consed expression graph: structurally identical subexpressions share
+// one node, operands of commutative operators are ordered canonically. Nodes
+// are stored in topological order, so Schedule can emit them front to back.
+class ExpressionDag {
+ public:
+  struct Node {
+    Instruction::OpCode op;
+    uint32_t a;
+    uint32_t b;
+    double value;
+  };
+
+  explicit ExpressionDag(const Program &program);
+
+  const std::vector<Node> &Nodes() const noexcept;
+  bool isEmpty() const noexcept;
+  uint32_t Root() const noexcept;
+
+  Program Schedule() const;
+
+ private:
+  struct Key {
+    Instruction::OpCode op;
+    uint32_t a;
+    uint32_t b;
+    uint64_t bits;
+
+    bool operator==(const Key &other) const noexcept;
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const noexcept;
+  };
+
+  uint32_t Intern(Instruction::OpCode op, uint32_t a, uint32_t b,
+                  double value);
+
+  std::vector<Node> nodes_;
+  std::unordered_map<Key, uint32_t, KeyHash> index_;
+  uint32_t root_ = 0;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_DAG_H_
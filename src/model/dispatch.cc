@@ -0,0 +1,106 @@
+#include "dispatch.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "kernels.h"
+
+namespace s21 {
+
+namespace dispatch {
+
+namespace {
+
+const char *const kTierNames[TIER_END] = {"scalar", "sse2", "avx2", "avx512"};
+
+CpuFeatures Detect() {
+  CpuFeatures features;
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  features.sse2 = __builtin_cpu_supports("sse2");
+  features.avx2 = __builtin_cpu_supports("avx2");
+  features.fma = __builtin_cpu_supports("fma");
+  features.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+  return features;
+}
+
+};  // namespace
+
+const CpuFeatures &DetectCpuFeatures() {
+  static const CpuFeatures features = Detect();
+  return features;
+}
+
+bool isSupported(Tier tier) {
+  const CpuFeatures &cpu = DetectCpuFeatures();
+  if (tier == SCALAR) {
+    return true;
+  } else if (tier == SSE2) {
+    return cpu.sse2 && kernels::Sse2();
+  } else if (tier == AVX2) {
+    return cpu.avx2 && cpu.fma && kernels::Avx2();
+  } else if (tier == AVX512) {
+    return cpu.avx512f && kernels::Avx512();
+  }
+  return false;
+}
+
+Tier BestTier() {
+  for (int tier = TIER_END - 1; tier > SCALAR; --tier) {
+    if (isSupported(Tier(tier))) {
+      return Tier(tier);
+    }
+  }
+  return SCALAR;
+}
+
+Tier SelectTier(const char *forced) {
+  Tier tier;
+  if (forced && ParseTier(forced, tier) && isSupported(tier)) {
+    return tier;
+  }
+  return BestTier();
+}
+
+Tier ActiveTier() {
+  static const Tier tier = SelectTier(std::getenv(kTierVariable));
+  return tier;
+}
+
+const char *TierName(Tier tier) {
+  return tier < TIER_END ? kTierNames[tier] : "";
+}
+
+bool ParseTier(const char *name, Tier &tier) {
+  for (int i = 0; i < TIER_END; ++i) {
+    if (!strcmp(name, kTierNames[i])) {
+      tier = Tier(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+const kernels::KernelTable &Table(Tier tier) {
+  const kernels::KernelTable *table = nullptr;
+  if (isSupported(tier)) {
+    if (tier == SSE2) {
+      table = kernels::Sse2();
+    } else if (tier == AVX2) {
+      table = kernels::Avx2();
+    } else if (tier == AVX512) {
+      table = kernels::Avx512();
+    }
+  }
+  return table ? *table : kernels::Scalar();
+}
+
+const kernels::KernelTable &Active() {
+  static const kernels::KernelTable &table = Table(ActiveTier());
+  return table;
+}
+
+};  // namespace dispatch
+
+};  // namespace s21
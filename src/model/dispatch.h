@@ -0,0 +1,46 @@
+#ifndef SMARTCALC_MODEL_DISPATCH_H_
+#define SMARTCALC_MODEL_DISPATCH_H_
+
+#include "kernels.h"
+
+namespace s21 {
+
+namespace dispatch {
+
+enum Tier {
+  SCALAR,
+  SSE2,
+  AVX2,
+  AVX512,
+  TIER_END,
+};
+
+struct CpuFeatures {
+  bool sse2 = false;
+  bool avx2 = false;
+  bool fma = false;
+  bool avx512f = false;
+};
+
+// The kernel tier is chosen once, on first use: the widest tier the CPU and OS
+// support, or the one named by SMARTCALC_KERNEL_TIER (scalar, sse2, avx2,
+// avx512) when it is supported.
+constexpr const char *kTierVariable = "SMARTCALC_KERNEL_TIER";
+
+const CpuFeatures &DetectCpuFeatures();
+bool isSupported(Tier tier);
+Tier BestTier();
+Tier SelectTier(const char *forced);
+Tier ActiveTier();
+
+const char *TierName(Tier tier);
+bool ParseTier(const char *name, Tier &tier);
+
+const kernels::KernelTable &Table(Tier tier);
+const kernels::KernelTable &Active();
+
+};  // namespace dispatch
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_DISPATCH_H_
@@ -0,0 +1,137 @@
+#include "dual.h"
+
+#include <cmath>
+#include <vector>
+
+namespace s21 {
+
+namespace {
+
+// f(a) given f(a.value) and the first two derivatives of f there.
+Dual Chain(const Dual &a, double value, double slope, double curvature) {
+  double second = a.second == 0 ? 0 : slope * a.second;
+  if (a.first != 0) {
+    second += curvature * a.first * a.first;
+  }
+  return {value, a.first == 0 ? 0 : slope * a.first, second};
+}
+
+Dual Power(const Dual &a, const Dual &b) {
+  double value = ::pow(a.value, b.value);
+  if (b.first == 0 && b.second == 0) {
+    // Constant exponent: also fine for negative bases and integer n.
+    double n = b.value;
+    double slope = n == 0 ? 0 : n * ::pow(a.value, n - 1);
+    double curvature =
+        n == 0 || n == 1 ? 0 : n * (n - 1) * ::pow(a.value, n - 2);
+    return Chain(a, value, slope, curvature);
+  }
+  // a^b = exp(w) with w = b ln a.
+  double log = ::log(a.value);
+  double ratio = a.first / a.value;
+  double w1 = b.first * log + b.value * ratio;
+  double w2 = b.second * log + 2 * b.first * ratio +
+              b.value * (a.second / a.value - ratio * ratio);
+  return {value, value * w1, value * (w2 + w1 * w1)};
+}
+
+};  // namespace
+
+Dual Dual::Variable(double x) noexcept { return {x, 1, 0}; }
+
+Dual Dual::Constant(double value) noexcept { return {value, 0, 0}; }
+
+Dual ApplyDual(Instruction::OpCode op, const Dual &a, const Dual &b) {
+  double u = a.value;
+  switch (op) {
+    case Instruction::NEG:
+      return {-a.value, -a.first, -a.second};
+    case Instruction::COS:
+      return Chain(a, ::cos(u), -::sin(u), -::cos(u));
+    case Instruction::SIN:
+      return Chain(a, ::sin(u), ::cos(u), -::sin(u));
+    case Instruction::TAN: {
+      double t = ::tan(u);
+      return Chain(a, t, 1 + t * t, 2 * t * (1 + t * t));
+    }
+    case Instruction::COTAN: {
+      double c = 1 / ::tan(u);
+      return Chain(a, c, -(1 + c * c), 2 * c * (1 + c * c));
+    }
+    case Instruction::ACOS: {
+      double r = 1 / ::sqrt(1 - u * u);
+      return Chain(a, ::acos(u), -r, -u * r * r * r);
+    }
+    case Instruction::ASIN: {
+      double r = 1 / ::sqrt(1 - u * u);
+      return Chain(a, ::asin(u), r, u * r * r * r);
+    }
+    case Instruction::ATAN: {
+      double r = 1 / (1 + u * u);
+      return Chain(a, ::atan(u), r, -2 * u * r * r);
+    }
+    case Instruction::SQRT: {
+      double s = ::sqrt(u);
+      return Chain(a, s, 0.5 / s, -0.25 / (s * s * s));
+    }
+    case Instruction::LN:
+      return Chain(a, ::log(u), 1 / u, -1 / (u * u));
+    case Instruction::LOG:
+      return Chain(a, ::log(u) / ::log(10), 1 / (u * ::log(10)),
+                   -1 / (u * u * ::log(10)));
+    case Instruction::ADD:
+      return {a.value + b.value, a.first + b.first, a.second + b.second};
+    case Instruction::SUB:
+      return {a.value - b.value, a.first - b.first, a.second - b.second};
+    case Instruction::MUL:
+      return {a.value * b.value, a.first * b.value + a.value * b.first,
+              a.second * b.value + 2 * a.first * b.first +
+                  a.value * b.second};
+    case Instruction::DIV: {
+      double q = a.value / b.value;
+      double q1 = (a.first - q * b.first) / b.value;
+      return {q, q1, (a.second - 2 * q1 * b.first - q * b.second) / b.value};
+    }
+    case Instruction::POW:
+      return Power(a, b);
+    case Instruction::MOD: {
+      // a - trunc(a / b) * b, piecewise smooth between the jumps.
+      double k = ::trunc(a.value / b.value);
+      return {::fmod(a.value, b.value), a.first - k * b.first,
+              a.second - k * b.second};
+    }
+    default:
+      return a;
+  }
+}
+
+void EvaluateDerivatives(const Program &program, const double *xs,
+                         double *values, double *first, double *second,
+                         size_t count) {
+  const std::vector<Instruction> &code = program.Code();
+  std::vector<Dual> slots(program.SlotCount());
+  for (size_t i = 0; i < count; ++i) {
+    Dual result;
+    for (const Instruction &ins : code) {
+      switch (ins.op) {
+        case Instruction::LOAD_X:
+          slots[ins.dst] = Dual::Variable(xs[i]);
+          break;
+        case Instruction::LOAD_CONST:
+          slots[ins.dst] = Dual::Constant(program.Constants()[ins.a]);
+          break;
+        default:
+          slots[ins.dst] = ApplyDual(ins.op, slots[ins.a], slots[ins.b]);
+          break;
+      }
+    }
+    if (!code.empty()) {
+      result = slots[program.Result()];
+    }
+    values[i] = result.value;
+    if (first) first[i] = result.first;
+    if (second) second[i] = result.second;
+  }
+}
+
+};  // namespace s21
@@ -0,0 +1,32 @@
+#ifndef SMARTCALC_MODEL_DUAL_H_
+#define SMARTCALC_MODEL_DUAL_H_
+
+#include <cstddef>
+
+#include "program.h"
+
+namespace s21 {
+
+// Truncated Taylor coefficients of a value with respect to x: the value and
+// its first and second derivatives, propagated exactly through every
+// operation by the chain rule (forward-mode differentiation).
+struct Dual {
+  double value = 0;
+  double first = 0;
+  double second = 0;
+
+  static Dual Variable(double x) noexcept;
+  static Dual Constant(double value) noexcept;
+};
+
+Dual ApplyDual(Instruction::OpCode op, const Dual &a, const Dual &b = {});
+
+// f, f' and f'' at every x in one pass over the program. first and second
+// may be null when not wanted.
+void EvaluateDerivatives(const Program &program, const double *xs,
+                         double *values, double *first, double *second,
+                         size_t count);
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_DUAL_H_
@@ -0,0 +1,105 @@
+#include "expression.h"
+
+#include <stack>
+#include <vector>
+
+namespace s21 {
+
+bool CompiledExpression::isEmpty() const noexcept { return rpn_.empty(); }
+
+bool CompiledExpression::isContainingX() const noexcept {
+  for (const Lexeme &lex : rpn_) {
+    if (lex.isVar()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CompiledExpression::isUsingNativeCode() const noexcept {
+  return native_ && native_->isLoaded();
+}
+
+const std::vector<Lexeme> &CompiledExpression::Rpn() const noexcept {
+  return rpn_;
+}
+
+const Program &CompiledExpression::Code() const noexcept { return program_; }
+
+double CompiledExpression::Evaluate(double x) const {
+  return jit_ && jit_->isCompiled() ? jit_->Evaluate(x)
+                                    : program_.Evaluate(x);
+}
+
+void CompiledExpression::EvaluateBatch(const double *xs, double *out,
+                                       size_t count) const {
+  if (isUsingNativeCode()) {
+    native_->EvaluateBatch(xs, out, count);
+  } else {
+    program_.EvaluateBatch(xs, out, count);
+  }
+}
+
+void CompiledExpression::EvaluateBatch(const double *xs, double *out,
+                                       size_t count, ThreadPool &pool,
+                                       size_t grain) const {
+  pool.ParallelFor(count, grain, [&](size_t begin, size_t end) {
+    EvaluateBatch(xs + begin, out + begin, end - begin);
+  });
+}
+
+void CompiledExpression::EvaluateDerivatives(const double *xs,
+                                             double *values, double *first,
+                                             double *second,
+                                             size_t count) const {
+  s21::EvaluateDerivatives(program_, xs, values, first, second, count);
+}
+
+void CompiledExpression::EvaluateDerivatives(const double *xs,
+                                             double *values, double *first,
+                                             double *second, size_t count,
+                                             ThreadPool &pool,
+                                             size_t grain) const {
+  pool.ParallelFor(count, grain, [&](size_t begin, size_t end) {
+    EvaluateDerivatives(xs + begin, values + begin,
+                        first ? first + begin : nullptr,
+                        second ? second + begin : nullptr, end - begin);
+  });
+}
+
+Interval CompiledExpression::Enclose(double low_x, double high_x) const {
+  return EvaluateInterval(program_, Interval::Of(low_x, high_x));
+}
+
+double CompiledExpression::EvaluateReference(double x) const {
+  if (rpn_.empty()) return 0;
+  std::stack<double> numstack;
+
+  for (auto lex : rpn_) {
+    if (lex.isVar()) {
+      numstack.push(x);
+    } else if (lex.isNumber()) {
+      numstack.push(lex.num);
+    } else if (lex.isFunction() || lex.isOperator()) {
+      if (numstack.size() < lex.operandCount) {
+        ThrowError(NOT_ENOUGH_OPERANDS);
+      }
+      std::vector<double> operands(lex.operandCount);
+      for (size_t i = 0; i < lex.operandCount; ++i) {
+        operands[lex.operandCount - i - 1] = numstack.top();
+        numstack.pop();
+      }
+      if (!lex.solver) {
+        ThrowError(UNIMPLEMENTED_SOLVER_CALLED);
+      }
+      numstack.push(lex.solver(operands));
+    }
+  }
+
+  if (numstack.size() > 1) {
+    ThrowError(MORE_NUMBERS_THAN_EXPECTED);
+  }
+  return numstack.top();
+}
+
+};  // namespace s21
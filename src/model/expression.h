@@ -0,0 +1,64 @@
+#ifndef SMARTCALC_MODEL_EXPRESSION_H_
+#define SMARTCALC_MODEL_EXPRESSION_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dual.h"
+#include "interval.h"
+#include "jit.h"
+#include "lexeme.h"
+#include "native.h"
+#include "program.h"
+#include "thread_pool.h"
+
+namespace s21 {
+
+// Result of compiling one input string. It is never modified after Compile
+// returns and every method is const and reentrant, so a single instance (or
+// copies of it, which share the generated code) can be evaluated from any
+// number of threads without locking.
+class CompiledExpression {
+ public:
+  bool isEmpty() const noexcept;
+  bool isContainingX() const noexcept;
+  bool isUsingNativeCode() const noexcept;
+  const std::vector<Lexeme> &Rpn() const noexcept;
+  const Program &Code() const noexcept;
+
+  double Evaluate(double x) const;
+  void EvaluateBatch(const double *xs, double *out, size_t count) const;
+  void EvaluateBatch(const double *xs, double *out, size_t count,
+                     ThreadPool &pool, size_t grain) const;
+  void EvaluateDerivatives(const double *xs, double *values, double *first,
+                           double *second, size_t count) const;
+  void EvaluateDerivatives(const double *xs, double *values, double *first,
+                           double *second, size_t count, ThreadPool &pool,
+                           size_t grain) const;
+  double EvaluateReference(double x) const;
+  Interval Enclose(double low_x, double high_x) const;
+
+ private:
+  friend class CalculatorModel;
+
+  std::vector<Lexeme> rpn_;
+  Program program_;
+  std::shared_ptr<const JitProgram> jit_;
+  std::shared_ptr<const NativeProgram> native_;
+};
+
+// Parses, folds and schedules input, then JIT-compiles it and, with
+// native_code, builds the dlopen backend; texts compiled before come from
+// ExpressionCache::Shared(). Throws std::invalid_argument on malformed input.
+CompiledExpression Compile(const std::string &input, bool native_code = false);
+// The same without exceptions for malformed input; out is only assigned when
+// the status is ok.
+ParseStatus TryCompile(std::string_view input, CompiledExpression &out,
+                       bool native_code = false);
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_EXPRESSION_H_
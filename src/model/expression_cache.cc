@@ -0,0 +1,130 @@
+#include "expression_cache.h"
+
+#include <cctype>
+
+namespace s21 {
+
+namespace {
+
+bool isWordChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '.';
+}
+
+bool isSign(char c) { return c == '+' || c == '-'; }
+
+bool isExponent(char c) { return c == 'e' || c == 'E'; }
+
+// Whether a token could continue from left into right: names and numbers,
+// and the sign of an exponent on either side.
+bool CanJoin(char before, char left, char right) {
+  return (isWordChar(left) && isWordChar(right)) ||
+         (isExponent(left) && isSign(right)) ||
+         (isExponent(before) && isSign(left) &&
+          std::isdigit(static_cast<unsigned char>(right)));
+}
+
+};  // namespace
+
+ExpressionCache::ExpressionCache(size_t capacity) : capacity_(capacity) {}
+
+ExpressionCache::Entry ExpressionCache::Get(std::string_view input,
+                                            bool native_code,
+                                            const Compiler &compile) {
+  Key key(Normalize(input), native_code);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+      ++stats_.hits;
+      entries_.splice(entries_.begin(), entries_, found->second);
+      return found->second->second;
+    }
+    ++stats_.misses;
+  }
+
+  Entry expression = compile();
+  if (!expression) {
+    return expression;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    // Compiled by another thread meanwhile.
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return found->second->second;
+  } else if (capacity_) {
+    entries_.emplace_front(key, expression);
+    index_.emplace(std::move(key), entries_.begin());
+    Evict();
+  }
+  return expression;
+}
+
+void ExpressionCache::SetCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  Evict();
+}
+
+size_t ExpressionCache::Capacity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+size_t ExpressionCache::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+ExpressionCache::Statistics ExpressionCache::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void ExpressionCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  index_.clear();
+  entries_.clear();
+}
+
+std::string ExpressionCache::Normalize(std::string_view input) {
+  std::string result;
+  result.reserve(input.size());
+  bool space = false;
+  for (char c : input) {
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      space = !result.empty();
+      continue;
+    }
+    if (space) {
+      char before = result.size() > 1 ? result[result.size() - 2] : ' ';
+      if (CanJoin(before, result.back(), c)) {
+        result.push_back(' ');
+      }
+      space = false;
+    }
+    result.push_back(c);
+  }
+  return result;
+}
+
+std::shared_ptr<ExpressionCache> ExpressionCache::Shared() {
+  static const std::shared_ptr<ExpressionCache> cache =
+      std::make_shared<ExpressionCache>();
+  return cache;
+}
+
+size_t ExpressionCache::KeyHash::operator()(const Key &key) const noexcept {
+  return std::hash<std::string>{}(key.first) * 2 + key.second;
+}
+
+// Caller holds mutex_.
+void ExpressionCache::Evict() {
+  while (entries_.size() > capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+    ++stats_.evictions;
+  }
+}
+
+};  // namespace s21
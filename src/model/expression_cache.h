@@ -0,0 +1,74 @@
+#ifndef SMARTCALC_MODEL_EXPRESSION_CACHE_H_
+#define SMARTCALC_MODEL_EXPRESSION_CACHE_H_
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "expression.h"
+
+namespace s21 {
+
+// Compiled expressions keyed by their whitespace-normalized text, with the
+// least recently used one evicted once capacity is reached. All members are
+// thread-safe, so one cache can serve every model and batch caller; Shared is
+// the one they use unless given another.
+class ExpressionCache {
+ public:
+  using Entry = std::shared_ptr<const CompiledExpression>;
+  // Builds the expression on a miss; null when the input does not compile,
+  // which is then not cached.
+  using Compiler = std::function<Entry()>;
+  struct Statistics {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  static constexpr size_t kCapacity = 64;
+
+  explicit ExpressionCache(size_t capacity = kCapacity);
+  ExpressionCache(const ExpressionCache &) = delete;
+  ExpressionCache &operator=(const ExpressionCache &) = delete;
+
+  // The cached expression for input, or what compile returns for it. The
+  // lock is not held while compiling.
+  Entry Get(std::string_view input, bool native_code, const Compiler &compile);
+
+  void SetCapacity(size_t capacity);
+  size_t Capacity() const;
+  size_t Size() const;
+  Statistics Stats() const;
+  void Clear();
+
+  // Drops whitespace that cannot separate two tokens and shrinks the rest to
+  // one space, so texts with the same key always lex the same.
+  static std::string Normalize(std::string_view input);
+  static std::shared_ptr<ExpressionCache> Shared();
+
+ private:
+  using Key = std::pair<std::string, bool>;
+  struct KeyHash {
+    size_t operator()(const Key &key) const noexcept;
+  };
+  using List = std::list<std::pair<Key, Entry>>;
+
+  void Evict();
+
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  List entries_;
+  std::unordered_map<Key, List::iterator, KeyHash> index_;
+  size_t capacity_;
+  Statistics stats_;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_EXPRESSION_CACHE_H_
@@ -0,0 +1,203 @@
+#include "integrator.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace s21 {
+
+namespace {
+
+constexpr size_t kNodes = 15;
+constexpr size_t kGrain = 64 * kNodes;
+
+// Abscissae of the 15-point Kronrod rule on [-1, 1], the odd ones shared
+// with the 7-point Gauss rule, and both sets of weights (QUADPACK qk15).
+constexpr double kAbscissae[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000,
+};
+constexpr double kKronrodWeights[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714,
+};
+constexpr double kGaussWeights[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327,
+};
+
+// Neumaier's compensated sum, in the order given.
+class Sum {
+ public:
+  void Add(double value) {
+    double total = sum_ + value;
+    if (std::fabs(sum_) >= std::fabs(value)) {
+      compensation_ += (sum_ - total) + value;
+    } else {
+      compensation_ += (value - total) + sum_;
+    }
+    sum_ = total;
+  }
+  double Value() const {
+    return std::isfinite(sum_) ? sum_ + compensation_ : sum_;
+  }
+
+ private:
+  double sum_ = 0;
+  double compensation_ = 0;
+};
+
+};  // namespace
+
+Integrator::Integrator(const CompiledExpression &expression, ThreadPool *pool,
+                       const IntegrationOptions &options)
+    : expression_(expression), pool_(pool), options_(options) {}
+
+Integral Integrator::Integrate(double low, double high) const {
+  Integral result;
+  if (low == high) {
+    result.converged = true;
+    return result;
+  }
+  std::vector<Segment> segments{{low, high, 0, 0}};
+  Evaluate(segments);
+  result.evaluations = kNodes;
+
+  while (true) {
+    Sum value, error;
+    for (const Segment &segment : segments) {
+      value.Add(segment.value);
+      error.Add(segment.error);
+    }
+    result.value = value.Value();
+    result.error = error.Value();
+    result.intervals = segments.size();
+    double tolerance = std::max(options_.absolute_tolerance,
+                                options_.relative_tolerance *
+                                    std::fabs(result.value));
+    if (result.error <= tolerance) {
+      result.converged = true;
+      break;
+    }
+
+    // The largest errors are split first, until what is left unsplit fits in
+    // half the tolerance. Infinite errors sort first and are always split.
+    std::vector<size_t> order(segments.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return segments[a].error > segments[b].error;
+    });
+    size_t budget = options_.max_intervals > segments.size()
+                        ? options_.max_intervals - segments.size()
+                        : 0;
+    Sum finite;
+    for (const Segment &segment : segments) {
+      if (std::isfinite(segment.error)) finite.Add(segment.error);
+    }
+    double remaining = finite.Value();
+    std::vector<size_t> split;
+    for (size_t i : order) {
+      const Segment &segment = segments[i];
+      bool infinite = !std::isfinite(segment.error);
+      if ((!infinite && !(remaining > tolerance / 2)) ||
+          split.size() == budget) {
+        break;
+      }
+      double middle = segment.low + (segment.high - segment.low) / 2;
+      if (middle != segment.low && middle != segment.high) {
+        split.push_back(i);
+        if (!infinite) remaining -= segment.error;
+      }
+    }
+    std::sort(split.begin(), split.end());
+    if (split.empty()) {
+      break;
+    }
+
+    std::vector<Segment> halves;
+    for (size_t i : split) {
+      const Segment &segment = segments[i];
+      double middle = segment.low + (segment.high - segment.low) / 2;
+      halves.push_back({segment.low, middle, 0, 0});
+      halves.push_back({middle, segment.high, 0, 0});
+    }
+    Evaluate(halves);
+    result.evaluations += halves.size() * kNodes;
+
+    std::vector<Segment> next;
+    next.reserve(segments.size() + split.size());
+    for (size_t i = 0, k = 0; i < segments.size(); ++i) {
+      if (k < split.size() && split[k] == i) {
+        next.push_back(halves[2 * k]);
+        next.push_back(halves[2 * k + 1]);
+        ++k;
+      } else {
+        next.push_back(segments[i]);
+      }
+    }
+    segments.swap(next);
+  }
+  return result;
+}
+
+// Fills value and error of every segment from one batch of 15 nodes each.
+void Integrator::Evaluate(std::vector<Segment> &segments) const {
+  std::vector<double> xs(segments.size() * kNodes), ys(xs.size());
+  for (size_t s = 0; s < segments.size(); ++s) {
+    double center = segments[s].low + (segments[s].high - segments[s].low) / 2;
+    double half = (segments[s].high - segments[s].low) / 2;
+    double *x = xs.data() + s * kNodes;
+    for (size_t j = 0; j < 7; ++j) {
+      x[j] = center - half * kAbscissae[j];
+      x[kNodes - 1 - j] = center + half * kAbscissae[j];
+    }
+    x[7] = center;
+  }
+  if (pool_) {
+    expression_.EvaluateBatch(xs.data(), ys.data(), xs.size(), *pool_,
+                              kGrain);
+  } else {
+    expression_.EvaluateBatch(xs.data(), ys.data(), xs.size());
+  }
+
+  for (size_t s = 0; s < segments.size(); ++s) {
+    const double *y = ys.data() + s * kNodes;
+    double half = (segments[s].high - segments[s].low) / 2;
+    double center = y[7];
+    double gauss = center * kGaussWeights[3];
+    double kronrod = center * kKronrodWeights[7];
+    double absolute = std::fabs(kronrod);
+    for (size_t j = 0; j < 7; ++j) {
+      double pair = y[j] + y[kNodes - 1 - j];
+      kronrod += kKronrodWeights[j] * pair;
+      absolute += kKronrodWeights[j] * (std::fabs(y[j]) +
+                                        std::fabs(y[kNodes - 1 - j]));
+      if (j % 2) gauss += kGaussWeights[j / 2] * pair;
+    }
+    double mean = kronrod / 2;
+    double spread = kKronrodWeights[7] * std::fabs(center - mean);
+    for (size_t j = 0; j < 7; ++j) {
+      spread += kKronrodWeights[j] * (std::fabs(y[j] - mean) +
+                                      std::fabs(y[kNodes - 1 - j] - mean));
+    }
+    double scale = std::fabs(half);
+    double error = std::fabs((kronrod - gauss) * half);
+    spread *= scale;
+    absolute *= scale;
+    // QUADPACK's scaling of |K - G|, bounded below by rounding.
+    if (spread != 0 && error != 0) {
+      error = spread * std::min(1.0, std::pow(200 * error / spread, 1.5));
+    }
+    if (absolute > DBL_MIN / (50 * DBL_EPSILON)) {
+      error = std::max(50 * DBL_EPSILON * absolute, error);
+    }
+    segments[s].value = kronrod * half;
+    segments[s].error = std::isfinite(segments[s].value) ? error : INFINITY;
+  }
+}
+
+};  // namespace s21
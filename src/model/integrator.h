@@ -0,0 +1,56 @@
+#ifndef SMARTCALC_MODEL_INTEGRATOR_H_
+#define SMARTCALC_MODEL_INTEGRATOR_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "expression.h"
+#include "thread_pool.h"
+
+namespace s21 {
+
+struct IntegrationOptions {
+  double absolute_tolerance = 1e-10;
+  double relative_tolerance = 1e-10;
+  size_t max_intervals = 2000;
+};
+
+struct Integral {
+  double value = 0;
+  // Estimated absolute error of value.
+  double error = 0;
+  size_t evaluations = 0;
+  size_t intervals = 0;
+  bool converged = false;
+};
+
+// Globally adaptive 7/15-point Gauss-Kronrod quadrature. Every round the
+// nodes of all new subintervals are evaluated as one batch spread over the
+// pool, then the subintervals whose error is above their share of the
+// tolerance are bisected. Results are combined in the order of x with
+// compensated summation, so the value and error are bit-identical for any
+// number of threads.
+class Integrator {
+ public:
+  explicit Integrator(const CompiledExpression &expression,
+                      ThreadPool *pool = nullptr,
+                      const IntegrationOptions &options = {});
+
+  Integral Integrate(double low, double high) const;
+
+ private:
+  struct Segment {
+    double low, high;
+    double value, error;
+  };
+
+  void Evaluate(std::vector<Segment> &segments) const;
+
+  const CompiledExpression &expression_;
+  ThreadPool *pool_;
+  IntegrationOptions options_;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_INTEGRATOR_H_
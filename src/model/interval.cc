@@ -0,0 +1,279 @@
+#include "interval.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <vector>
+
+namespace s21 {
+
+namespace {
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+// Relative widening of results: two ulps cover correctly rounded arithmetic,
+// sixteen cover libm plus the up to four ulps of the vector kernels.
+constexpr double kExact = 2 * DBL_EPSILON;
+constexpr double kLibm = 16 * DBL_EPSILON;
+
+double Down(double value, double relative) {
+  if (!std::isfinite(value)) return value;
+  return value - (std::fabs(value) * relative + DBL_TRUE_MIN);
+}
+
+double Up(double value, double relative) {
+  if (!std::isfinite(value)) return value;
+  return value + (std::fabs(value) * relative + DBL_TRUE_MIN);
+}
+
+Interval Widen(Interval r, double relative) {
+  r.low = Down(r.low, relative);
+  r.high = Up(r.high, relative);
+  return r;
+}
+
+// Smallest interval holding every non-NaN value; NaN values only mark the
+// result as partial.
+Interval Hull(std::initializer_list<double> values, bool partial,
+              double relative) {
+  Interval r{kInfinity, -kInfinity, partial};
+  for (double value : values) {
+    if (std::isnan(value)) {
+      r.partial = true;
+    } else {
+      r.low = std::min(r.low, value);
+      r.high = std::max(r.high, value);
+    }
+  }
+  return r.isEmpty() ? Interval::Empty() : Widen(r, relative);
+}
+
+// Whether low <= offset + k * period <= high for some integer k. Errs on the
+// side of yes, which only makes the enclosure wider.
+bool ContainsMultiple(double low, double high, double period, double offset) {
+  if (!std::isfinite(low) || !std::isfinite(high) || high - low >= period) {
+    return true;
+  }
+  double from = (low - offset) / period, to = (high - offset) / period;
+  double slack = 1e-9 * (1 + std::max(std::fabs(from), std::fabs(to)));
+  return std::floor(to + slack) >= std::ceil(from - slack);
+}
+
+// sin or cos: maxima at peak + 2k * pi, minima half a period later and
+// monotonic in between.
+Interval Periodic(Instruction::OpCode op, const Interval &a, double peak) {
+  Interval r = Hull({Program::ApplyScalar(op, a.low),
+                     Program::ApplyScalar(op, a.high)},
+                    a.partial, kLibm);
+  if (ContainsMultiple(a.low, a.high, 2 * M_PI, peak)) r.high = 1;
+  if (ContainsMultiple(a.low, a.high, 2 * M_PI, peak + M_PI)) r.low = -1;
+  r.low = std::max(r.low, Down(-1, kLibm));
+  r.high = std::min(r.high, Up(1, kLibm));
+  r.partial |= !std::isfinite(a.low) || !std::isfinite(a.high);
+  return r;
+}
+
+// Restricts a to [low, high], the domain of a function.
+bool Clip(Interval &a, double low, double high) {
+  if (a.high < low || a.low > high) return false;
+  if (a.low < low || a.high > high) a.partial = true;
+  a.low = std::max(a.low, low);
+  a.high = std::min(a.high, high);
+  return true;
+}
+
+Interval Divide(const Interval &a, const Interval &b) {
+  bool partial = a.partial || b.partial;
+  if (b.low > 0 || b.high < 0) {
+    // Finite values over an infinite divisor give zero, even where the
+    // corners are inf / inf.
+    bool zero = !a.isBounded() && !b.isBounded() &&
+                a.low < kInfinity && a.high > -kInfinity;
+    return Hull({a.low / b.low, a.low / b.high, a.high / b.low,
+                 a.high / b.high, zero ? 0 : a.low / b.low},
+                partial, kExact);
+  }
+  Interval r = Interval::Whole();
+  r.partial = partial || a.Contains(0) || (b.low == 0 && b.high == 0);
+  return r;
+}
+
+// Integer powers, and infinite ones that behave like even powers, keep
+// negative bases defined.
+Interval IntegerPower(const Interval &a, double n, bool partial) {
+  bool odd = std::isfinite(n) && std::fmod(n, 2) != 0;
+  if (odd && n > 0) {
+    return Hull({::pow(a.low, n), ::pow(a.high, n)}, partial, kLibm);
+  } else if (odd) {
+    if (a.Contains(0)) return {-kInfinity, kInfinity, partial};
+    return Hull({::pow(a.low, n), ::pow(a.high, n)}, partial, kLibm);
+  }
+  double magnitude = std::max(std::fabs(a.low), std::fabs(a.high));
+  double mignitude = a.Contains(0) ? 0 : std::min(std::fabs(a.low),
+                                                  std::fabs(a.high));
+  return Hull({::pow(mignitude, n), ::pow(magnitude, n)}, partial, kLibm);
+}
+
+// For a positive base pow is monotonic in each argument, so the extremes are
+// at the corners.
+Interval Power(Interval a, const Interval &b) {
+  bool partial = a.partial || b.partial;
+  bool integer = b.low == b.high && b.low == std::trunc(b.low);
+  if (a.low < 0 && integer) {
+    return IntegerPower(a, b.low, partial);
+  } else if (a.low < 0 && b.low != b.high) {
+    Interval r = Interval::Whole();
+    r.partial = true;
+    return r;
+  } else if (a.low < 0) {
+    // Of the negative bases only -inf has a power.
+    Interval infinite = a.low == -kInfinity
+                            ? Interval::Point(::pow(a.low, b.low))
+                            : Interval::Empty();
+    infinite.partial = true;
+    if (!Clip(a, 0, kInfinity)) return infinite;
+    Interval r = Hull({::pow(a.low, b.low), ::pow(a.high, b.low)}, true,
+                      kLibm);
+    r.low = std::min(r.low, infinite.low);
+    r.high = std::max(r.high, infinite.high);
+    return r;
+  }
+  return Hull({::pow(a.low, b.low), ::pow(a.low, b.high),
+               ::pow(a.high, b.low), ::pow(a.high, b.high)},
+              partial, kLibm);
+}
+
+// fmod keeps the sign of a and is smaller than both |a| and |b|; within one
+// period of a constant b it is a shifted copy of a.
+Interval Modulo(const Interval &a, const Interval &b) {
+  bool partial = a.partial || b.partial || b.Contains(0) ||
+                 !std::isfinite(a.low) || !std::isfinite(a.high);
+  double modulus = std::max(std::fabs(b.low), std::fabs(b.high));
+  if (b.low == b.high && !partial && a.high - a.low < modulus &&
+      (a.low >= 0 || a.high <= 0)) {
+    double low = ::fmod(a.low, b.low), high = ::fmod(a.high, b.low);
+    if (low <= high) return Interval::Of(low, high);
+  }
+  Interval r{a.low >= 0 ? 0 : std::max(a.low, -modulus),
+             a.high <= 0 ? 0 : std::min(a.high, modulus), partial};
+  return r;
+}
+
+};  // namespace
+
+Interval Interval::Point(double value) noexcept {
+  return std::isnan(value) ? Empty() : Interval{value, value, false};
+}
+
+Interval Interval::Of(double low, double high) noexcept {
+  return {std::min(low, high), std::max(low, high), false};
+}
+
+Interval Interval::Empty() noexcept { return {kInfinity, -kInfinity, true}; }
+
+Interval Interval::Whole() noexcept { return {-kInfinity, kInfinity, false}; }
+
+bool Interval::isEmpty() const noexcept { return !(low <= high); }
+
+bool Interval::isPartial() const noexcept { return partial; }
+
+bool Interval::isBounded() const noexcept {
+  return !isEmpty() && std::isfinite(low) && std::isfinite(high);
+}
+
+bool Interval::Contains(double value) const noexcept {
+  return value >= low && value <= high;
+}
+
+Interval ApplyInterval(Instruction::OpCode op, const Interval &a,
+                       const Interval &b) {
+  if (op == Instruction::POW && (a.isEmpty() || b.isEmpty())) {
+    // pow(NaN, 0) and pow(1, NaN) are 1.
+    bool one = a.isEmpty() ? !b.isEmpty() && b.Contains(0) : a.Contains(1);
+    return one ? Interval{1, 1, true} : Interval::Empty();
+  } else if (a.isEmpty() || (Instruction::Arity(op) == 2 && b.isEmpty())) {
+    return Interval::Empty();
+  }
+  bool partial = a.partial || b.partial;
+  Interval domain = a;
+  switch (op) {
+    case Instruction::NEG:
+      return {-a.high, -a.low, a.partial};
+    case Instruction::COS:
+      return Periodic(op, a, 0);
+    case Instruction::SIN:
+      return Periodic(op, a, M_PI_2);
+    case Instruction::TAN:
+      if (ContainsMultiple(a.low, a.high, M_PI, M_PI_2)) {
+        return {-kInfinity, kInfinity, a.partial || !a.isBounded()};
+      }
+      return Hull({::tan(a.low), ::tan(a.high)}, a.partial, kLibm);
+    case Instruction::COTAN:
+      if (ContainsMultiple(a.low, a.high, M_PI, 0)) {
+        return {-kInfinity, kInfinity, a.partial || !a.isBounded()};
+      }
+      return Hull({1 / ::tan(a.low), 1 / ::tan(a.high)}, a.partial, kLibm);
+    case Instruction::ACOS:
+      if (!Clip(domain, -1, 1)) return Interval::Empty();
+      return Hull({::acos(domain.low), ::acos(domain.high)}, domain.partial,
+                  kLibm);
+    case Instruction::ASIN:
+      if (!Clip(domain, -1, 1)) return Interval::Empty();
+      return Hull({::asin(domain.low), ::asin(domain.high)}, domain.partial,
+                  kLibm);
+    case Instruction::ATAN:
+      return Hull({::atan(a.low), ::atan(a.high)}, a.partial, kLibm);
+    case Instruction::SQRT:
+      if (!Clip(domain, 0, kInfinity)) return Interval::Empty();
+      return Hull({::sqrt(domain.low), ::sqrt(domain.high)}, domain.partial,
+                  kExact);
+    case Instruction::LN:
+    case Instruction::LOG:
+      if (!Clip(domain, 0, kInfinity)) return Interval::Empty();
+      return Hull({Program::ApplyScalar(op, domain.low),
+                   Program::ApplyScalar(op, domain.high)},
+                  domain.partial, kLibm);
+    case Instruction::ADD:
+      return Hull({a.low + b.low, a.high + b.high}, partial, kExact);
+    case Instruction::SUB:
+      return Hull({a.low - b.high, a.high - b.low}, partial, kExact);
+    case Instruction::MUL:
+      // 0 * inf is NaN even when neither is a corner.
+      partial |= (a.Contains(0) && !b.isBounded()) ||
+                 (b.Contains(0) && !a.isBounded());
+      return Hull({a.low * b.low, a.low * b.high, a.high * b.low,
+                   a.high * b.high},
+                  partial, kExact);
+    case Instruction::DIV:
+      return Divide(a, b);
+    case Instruction::POW:
+      return Power(a, b);
+    case Instruction::MOD:
+      return Modulo(a, b);
+    default:
+      return a;
+  }
+}
+
+Interval EvaluateInterval(const Program &program, const Interval &x) {
+  const std::vector<Instruction> &code = program.Code();
+  if (code.empty()) return Interval::Point(0);
+  std::vector<Interval> slots(program.SlotCount());
+  for (const Instruction &ins : code) {
+    switch (ins.op) {
+      case Instruction::LOAD_X:
+        slots[ins.dst] = x;
+        break;
+      case Instruction::LOAD_CONST:
+        slots[ins.dst] = Interval::Point(program.Constants()[ins.a]);
+        break;
+      default:
+        slots[ins.dst] = ApplyInterval(ins.op, slots[ins.a], slots[ins.b]);
+        break;
+    }
+  }
+  return slots[program.Result()];
+}
+
+};  // namespace s21
@@ -0,0 +1,36 @@
+#ifndef SMARTCALC_MODEL_INTERVAL_H_
+#define SMARTCALC_MODEL_INTERVAL_H_
+
+#include "program.h"
+
+namespace s21 {
+
+// Closed range of doubles that encloses every value an expression can take
+// over a range of x. Endpoints are rounded outwards by more than the error of
+// libm and of the vector kernels, so values computed by Evaluate and
+// EvaluateBatch are always inside. An empty interval (low > high) means the
+// expression is undefined (NaN) everywhere; isPartial() means it may be NaN
+// somewhere inside the range.
+struct Interval {
+  double low = 0;
+  double high = 0;
+  bool partial = false;
+
+  static Interval Point(double value) noexcept;
+  static Interval Of(double low, double high) noexcept;
+  static Interval Empty() noexcept;
+  static Interval Whole() noexcept;
+
+  bool isEmpty() const noexcept;
+  bool isPartial() const noexcept;
+  bool isBounded() const noexcept;
+  bool Contains(double value) const noexcept;
+};
+
+Interval ApplyInterval(Instruction::OpCode op, const Interval &a,
+                       const Interval &b = {});
+Interval EvaluateInterval(const Program &program, const Interval &x);
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_INTERVAL_H_
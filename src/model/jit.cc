@@ -0,0 +1,273 @@
+#include "jit.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define S21_JIT_SUPPORTED 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+#ifdef S21_JIT_SUPPORTED
+
+using Callee = double (*)(double, double);
+
+template <Instruction::OpCode op>
+double Call(double a, double b) {
+  return Program::ApplyScalar(op, a, b);
+}
+
+template <size_t... ops>
+std::vector<Callee> MakeCallees(std::index_sequence<ops...>) {
+  return {&Call<Instruction::OpCode(ops)>...};
+}
+
+const std::vector<Callee> &Callees() {
+  static const std::vector<Callee> callees =
+      MakeCallees(std::make_index_sequence<Instruction::OPCODE_END>());
+  return callees;
+}
+
+// Emits System V x86-64 code for double f(double x, double *slots). rbx holds
+// slots, x is spilled to [rsp], slot i lives at [rbx + 8 * i]. xmm0 caches the
+// slot that was stored last, which saves the reload in operator chains.
+class Assembler {
+ public:
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  std::vector<uint8_t> Assemble(const Program &program) {
+    Bytes({0x53});                          // push rbx
+    Bytes({0x48, 0x83, 0xec, 0x10});        // sub rsp, 16
+    Bytes({0x48, 0x89, 0xfb});              // mov rbx, rdi
+    Bytes({0xf2, 0x0f, 0x11, 0x04, 0x24});  // movsd [rsp], xmm0
+    for (const Instruction &ins : program.Code()) {
+      Emit(ins, program.Constants());
+    }
+    if (program.isEmpty()) {
+      Bytes({0x66, 0x0f, 0x57, 0xc0});  // xorpd xmm0, xmm0
+    } else {
+      Load(program.Result());
+    }
+    Bytes({0x48, 0x83, 0xc4, 0x10});  // add rsp, 16
+    Bytes({0x5b, 0xc3});              // pop rbx; ret
+    return std::move(code_);
+  }
+
+ private:
+  void Emit(const Instruction &ins, const std::vector<double> &constants) {
+    switch (ins.op) {
+      case Instruction::LOAD_X:
+        Bytes({0xf2, 0x0f, 0x10, 0x04, 0x24});  // movsd xmm0, [rsp]
+        cached_ = kNone;
+        Store(ins.dst);
+        break;
+      case Instruction::LOAD_CONST: {
+        uint64_t bits;
+        std::memcpy(&bits, &constants[ins.a], sizeof(bits));
+        Bytes({0x48, 0xb8});  // mov rax, imm64
+        Imm64(bits);
+        StoreRax(ins.dst);
+        break;
+      }
+      case Instruction::NEG:
+        SlotOperand({0x48, 0x8b}, 0, ins.a);     // mov rax, [a]
+        Bytes({0x48, 0x0f, 0xba, 0xf8, 0x3f});  // btc rax, 63
+        StoreRax(ins.dst);
+        break;
+      case Instruction::SQRT:
+        SlotOperand({0xf2, 0x0f, 0x51}, 0, ins.a);  // sqrtsd xmm0, [a]
+        cached_ = kNone;
+        Store(ins.dst);
+        break;
+      case Instruction::ADD:
+      case Instruction::SUB:
+      case Instruction::MUL:
+      case Instruction::DIV:
+        Load(ins.a);
+        SlotOperand({0xf2, 0x0f, Arithmetic(ins.op)}, 0, ins.b);
+        cached_ = kNone;
+        Store(ins.dst);
+        break;
+      default:
+        Load(ins.a);
+        if (ins.isBinary()) {
+          SlotOperand({0xf2, 0x0f, 0x10}, 1, ins.b);  // movsd xmm1, [b]
+        }
+        Bytes({0x48, 0xb8});  // mov rax, imm64
+        Imm64(reinterpret_cast<uint64_t>(Callees()[ins.op]));
+        Bytes({0xff, 0xd0});  // call rax
+        cached_ = kNone;
+        Store(ins.dst);
+        break;
+    }
+  }
+
+  static uint8_t Arithmetic(Instruction::OpCode op) {
+    if (op == Instruction::ADD) return 0x58;
+    if (op == Instruction::MUL) return 0x59;
+    if (op == Instruction::SUB) return 0x5c;
+    return 0x5e;
+  }
+
+  void Load(uint32_t slot) {
+    if (cached_ != slot) {
+      SlotOperand({0xf2, 0x0f, 0x10}, 0, slot);  // movsd xmm0, [slot]
+      cached_ = slot;
+    }
+  }
+
+  void Store(uint32_t slot) {
+    SlotOperand({0xf2, 0x0f, 0x11}, 0, slot);  // movsd [slot], xmm0
+    cached_ = slot;
+  }
+
+  void StoreRax(uint32_t slot) {
+    SlotOperand({0x48, 0x89}, 0, slot);  // mov [slot], rax
+    if (cached_ == slot) {
+      cached_ = kNone;
+    }
+  }
+
+  // opcode reg, [rbx + disp32]
+  void SlotOperand(std::initializer_list<uint8_t> opcode, uint8_t reg,
+                   uint32_t slot) {
+    Bytes(opcode);
+    Bytes({uint8_t(0x83 | reg << 3)});
+    uint32_t displacement = slot * sizeof(double);
+    for (int i = 0; i < 4; ++i) {
+      code_.push_back(displacement >> (8 * i));
+    }
+  }
+
+  void Bytes(std::initializer_list<uint8_t> bytes) {
+    code_.insert(code_.end(), bytes);
+  }
+
+  void Imm64(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      code_.push_back(value >> (8 * i));
+    }
+  }
+
+  std::vector<uint8_t> code_;
+  uint32_t cached_ = kNone;
+};
+
+#endif
+
+bool ReadAvailability() {
+#ifdef S21_JIT_SUPPORTED
+  const char *value = std::getenv(kJitVariable);
+  return !value || strcmp(value, "0");
+#else
+  return false;
+#endif
+}
+
+};  // namespace
+
+JitProgram::JitProgram(const Program &program) {
+#ifdef S21_JIT_SUPPORTED
+  if (!isAvailable() || program.SlotCount() > UINT32_MAX / sizeof(double)) {
+    return;
+  }
+  std::vector<uint8_t> code = Assembler().Assemble(program);
+  size_t page = sysconf(_SC_PAGESIZE);
+  size_t size = (code.size() + page - 1) / page * page;
+  void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    return;
+  }
+  std::memcpy(memory, code.data(), code.size());
+  if (mprotect(memory, size, PROT_READ | PROT_EXEC)) {
+    munmap(memory, size);
+    return;
+  }
+  page_ = memory;
+  page_size_ = size;
+  code_size_ = code.size();
+  slot_count_ = program.SlotCount();
+  function_ = reinterpret_cast<Function>(memory);
+#else
+  (void)program;
+#endif
+}
+
+JitProgram::JitProgram(JitProgram &&other) noexcept {
+  *this = std::move(other);
+}
+
+JitProgram &JitProgram::operator=(JitProgram &&other) noexcept {
+  if (this != &other) {
+    Release();
+    std::swap(page_, other.page_);
+    std::swap(page_size_, other.page_size_);
+    std::swap(code_size_, other.code_size_);
+    std::swap(slot_count_, other.slot_count_);
+    std::swap(function_, other.function_);
+  }
+  return *this;
+}
+
+JitProgram::~JitProgram() { Release(); }
+
+bool JitProgram::isAvailable() {
+  static const bool available = ReadAvailability();
+  return available;
+}
+
+bool JitProgram::isCompiled() const noexcept { return function_; }
+size_t JitProgram::CodeSize() const noexcept { return code_size_; }
+
+double JitProgram::Evaluate(double x) const {
+  double slots[kInlineSlots];
+  return Evaluate(x, slot_count_ <= kInlineSlots ? slots : LargeSlots());
+}
+
+double JitProgram::Evaluate(double x, double *slots) const noexcept {
+  return function_(x, slots);
+}
+
+void JitProgram::EvaluateBatch(const double *xs, double *out,
+                               size_t count) const {
+  double inline_slots[kInlineSlots];
+  double *slots = slot_count_ <= kInlineSlots ? inline_slots : LargeSlots();
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = function_(xs[i], slots);
+  }
+}
+
+// Programs are shared by the threads of a pool, so the slots that do not fit
+// on the stack are kept per thread, grown once and reused by every call.
+double *JitProgram::LargeSlots() const {
+  thread_local std::vector<double> slots;
+  if (slots.size() < slot_count_) {
+    slots.resize(slot_count_);
+  }
+  return slots.data();
+}
+
+void JitProgram::Release() noexcept {
+#ifdef S21_JIT_SUPPORTED
+  if (page_) {
+    munmap(page_, page_size_);
+  }
+#endif
+  page_ = nullptr;
+  page_size_ = 0;
+  code_size_ = 0;
+  slot_count_ = 0;
+  function_ = nullptr;
+}
+
+};  // namespace s21
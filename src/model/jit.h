@@ -0,0 +1,52 @@
+#ifndef SMARTCALC_MODEL_JIT_H_
+#define SMARTCALC_MODEL_JIT_H_
+
+#include <cstddef>
+
+#include "program.h"
+
+namespace s21 {
+
+// Native x86-64 translation of a Program, placed in its own executable page.
+// Slots stay in memory exactly as in Program::Evaluate and every operation is
+// one scalar SSE2 instruction or a call to the same libm formula, so results
+// are bitwise identical to the interpreter. The JIT is skipped (isCompiled()
+// is false) off x86-64 Linux/macOS, when the OS refuses an executable mapping,
+// or when SMARTCALC_JIT is set to 0; callers then use the Program instead.
+constexpr const char *kJitVariable = "SMARTCALC_JIT";
+
+class JitProgram {
+ public:
+  JitProgram() = default;
+  explicit JitProgram(const Program &program);
+  JitProgram(JitProgram &&other) noexcept;
+  JitProgram &operator=(JitProgram &&other) noexcept;
+  JitProgram(const JitProgram &) = delete;
+  JitProgram &operator=(const JitProgram &) = delete;
+  ~JitProgram();
+
+  static bool isAvailable();
+  bool isCompiled() const noexcept;
+  size_t CodeSize() const noexcept;
+
+  double Evaluate(double x) const;
+  double Evaluate(double x, double *slots) const noexcept;
+  void EvaluateBatch(const double *xs, double *out, size_t count) const;
+
+ private:
+  using Function = double (*)(double x, double *slots);
+  static constexpr size_t kInlineSlots = 64;
+
+  double *LargeSlots() const;
+  void Release() noexcept;
+
+  void *page_ = nullptr;
+  size_t page_size_ = 0;
+  size_t code_size_ = 0;
+  size_t slot_count_ = 0;
+  Function function_ = nullptr;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_JIT_H_
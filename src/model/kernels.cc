@@ -0,0 +1,130 @@
+#include "kernels.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "program.h"
+
+namespace s21 {
+
+namespace kernels {
+
+namespace scalar {
+
+template <Instruction::OpCode Op>
+void Unary(const double *a, double *out, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = Program::ApplyScalar(Op, a[i]);
+  }
+}
+
+template <Instruction::OpCode Op>
+void Binary(const double *a, const double *b, double *out, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = Program::ApplyScalar(Op, a[i], b[i]);
+  }
+}
+
+const KernelTable kTable{
+    "scalar",
+    {nullptr, nullptr, nullptr, &Unary<Instruction::NEG>,
+     &Unary<Instruction::COS>, &Unary<Instruction::SIN>,
+     &Unary<Instruction::TAN>, &Unary<Instruction::COTAN>,
+     &Unary<Instruction::ACOS>, &Unary<Instruction::ASIN>,
+     &Unary<Instruction::ATAN>, &Unary<Instruction::SQRT>,
+     &Unary<Instruction::LN>, &Unary<Instruction::LOG>},
+    {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+     nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+     &Binary<Instruction::ADD>, &Binary<Instruction::SUB>,
+     &Binary<Instruction::MUL>, &Binary<Instruction::DIV>,
+     &Binary<Instruction::POW>, &Binary<Instruction::MOD>},
+};
+
+};  // namespace scalar
+
+#if defined(__x86_64__)
+
+#define S21_KERNEL_TIER sse2
+#define S21_KERNEL_NAME "sse2"
+#define S21_KERNEL_LANES 2
+#define S21_KERNEL_SQRT _mm_sqrt_pd
+#define S21_KERNEL_NO_FMA
+#include "kernels.inc"
+#undef S21_KERNEL_TIER
+#undef S21_KERNEL_NAME
+#undef S21_KERNEL_LANES
+#undef S21_KERNEL_SQRT
+#undef S21_KERNEL_NO_FMA
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+#define S21_KERNEL_TIER avx2
+#define S21_KERNEL_NAME "avx2"
+#define S21_KERNEL_LANES 4
+#define S21_KERNEL_SQRT _mm256_sqrt_pd
+#define S21_KERNEL_FMA _mm256_fmadd_pd
+#include "kernels.inc"
+#undef S21_KERNEL_TIER
+#undef S21_KERNEL_NAME
+#undef S21_KERNEL_LANES
+#undef S21_KERNEL_SQRT
+#undef S21_KERNEL_FMA
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+#define S21_KERNEL_TIER avx512
+#define S21_KERNEL_NAME "avx512"
+#define S21_KERNEL_LANES 8
+#define S21_KERNEL_SQRT(v) _mm512_mask_sqrt_pd(v, 0xff, v)
+#define S21_KERNEL_FMA _mm512_fmadd_pd
+#include "kernels.inc"
+#undef S21_KERNEL_TIER
+#undef S21_KERNEL_NAME
+#undef S21_KERNEL_LANES
+#undef S21_KERNEL_SQRT
+#undef S21_KERNEL_FMA
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+const KernelTable *Sse2() { return &sse2::kTable; }
+const KernelTable *Avx2() { return &avx2::kTable; }
+const KernelTable *Avx512() { return &avx512::kTable; }
+
+#else
+
+const KernelTable *Sse2() { return nullptr; }
+const KernelTable *Avx2() { return nullptr; }
+const KernelTable *Avx512() { return nullptr; }
+
+#endif
+
+const KernelTable &Scalar() { return scalar::kTable; }
+
+};  // namespace kernels
+
+};  // namespace s21
@@ -0,0 +1,43 @@
+#ifndef SMARTCALC_MODEL_KERNELS_H_
+#define SMARTCALC_MODEL_KERNELS_H_
+
+#include <cstddef>
+
+#include "program.h"
+
+namespace s21 {
+
+namespace kernels {
+
+using UnaryKernel = void (*)(const double *a, double *out, size_t count);
+using BinaryKernel = void (*)(const double *a, const double *b, double *out,
+                              size_t count);
+
+// Column kernels for every arithmetic opcode of a Program, indexed by opcode.
+// Output may alias an input. The scalar table calls the same libm functions as
+// CalculatorModel::Solver; vector tables stay within these bounds of it
+// (measured by tests/kernels_test.cc over the whole double range):
+//   neg, add, sub, mul, div, sqrt, mod          exact
+//   sin, cos, atan, ln, pow                     2 ulp
+//   asin, acos                                  3 ulp
+//   tan, cotan, log                             4 ulp
+// Arguments outside the vector fast paths (|x| > 2^20 for trigonometry,
+// non-finite or zero pow arguments, fmod with huge quotients) are handled lane
+// by lane with libm, so NaN, infinities and domain errors match the scalar
+// result exactly.
+struct KernelTable {
+  const char *name;
+  UnaryKernel unary[Instruction::OPCODE_END];
+  BinaryKernel binary[Instruction::OPCODE_END];
+};
+
+const KernelTable &Scalar();
+const KernelTable *Sse2();
+const KernelTable *Avx2();
+const KernelTable *Avx512();
+
+};  // namespace kernels
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_KERNELS_H_
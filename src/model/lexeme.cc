@@ -0,0 +1,48 @@
+#include "lexeme.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace s21 {
+
+bool Lexeme::isNumber() const noexcept { return ftype == NUMBER; }
+bool Lexeme::isVar() const noexcept { return type == XNUM; }
+bool Lexeme::isFunction() const noexcept { return ftype == FUNCTION; }
+bool Lexeme::isOperator() const noexcept { return ftype == OPERATOR; }
+
+bool ParseStatus::isOk() const noexcept { return code == NO_ERROR; }
+std::string ParseStatus::Message() const {
+  return ErrorMessage(code, position);
+}
+
+std::string ErrorMessage(enum ErrorCode code, size_t position) {
+  if (code == INCORRECT_LEXEME) {
+    return std::string("Incorrect Lexeme Type at char ") +
+           std::to_string(position);
+  } else if (code == INCORRECT_NUMBER) {
+    return std::string("Incorrect Number Value at char ") +
+           std::to_string(position);
+  } else if (code == UNCLOSED_PARENT) {
+    return std::string("Found parenthesis (unclosed) without a pair");
+  } else if (code == UNOPENED_PARENT) {
+    return std::string(
+               "Found parenthesis (unopened) without a pair at lexem #") +
+           std::to_string(position + 1);
+  } else if (code == NOT_ENOUGH_OPERANDS) {
+    return std::string("Some operator/function had not enough operands");
+  } else if (code == MORE_NUMBERS_THAN_EXPECTED) {
+    return std::string(
+        "Found two or more numbers in a row without an operator");
+  } else if (code == UNIMPLEMENTED_SOLVER_CALLED) {
+    return std::string("Operator that wasn't implemented can't be applied");
+  }
+  return std::string();
+}
+
+void ThrowError(enum ErrorCode code, size_t position) {
+  if (code != NO_ERROR) {
+    throw std::invalid_argument(ErrorMessage(code, position));
+  }
+}
+
+};  // namespace s21
@@ -0,0 +1,90 @@
+#ifndef SMARTCALC_MODEL_LEXEME_H_
+#define SMARTCALC_MODEL_LEXEME_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "program.h"
+
+namespace s21 {
+
+enum ErrorCode {
+  NO_ERROR,
+  INCORRECT_LEXEME,
+  INCORRECT_NUMBER,
+  UNCLOSED_PARENT,
+  UNOPENED_PARENT,
+  NOT_ENOUGH_OPERANDS,
+  MORE_NUMBERS_THAN_EXPECTED,
+  UNIMPLEMENTED_SOLVER_CALLED,
+};
+
+struct Lexeme {
+  enum Type {
+    NO_TYPE,
+    UPLUS,
+    UMINUS,
+    ADD,
+    SUB,
+    XNUM,
+    NUM,
+    POW,
+    MUL,
+    DIV,
+    MOD,
+    LEFTPAR,
+    RIGHTPAR,
+    COS,
+    SIN,
+    TAN,
+    COTAN,
+    ACOS,
+    ASIN,
+    ATAN,
+    SQRT,
+    LN,
+    LOG,
+    END,
+  };
+  enum Associativity { NO_ASSOC, ASSOC_LEFT, ASSOC_RIGHT };
+  enum FundamentalType {
+    NO_FUNDAMENTAL_TYPE,
+    NUMBER,
+    FUNCTION,
+    OPERATOR,
+    PARENTHESIS,
+  };
+
+  enum Type type = NO_TYPE;
+  size_t priority = -1;
+  double num = 0;
+  size_t operandCount = 0;
+  enum Associativity assoc = NO_ASSOC;
+  enum FundamentalType ftype = NO_FUNDAMENTAL_TYPE;
+  double (*solver)(const std::vector<double> &);
+  Instruction::OpCode opcode = Instruction::NOP;
+
+  bool isNumber() const noexcept;
+  bool isVar() const noexcept;
+  bool isFunction() const noexcept;
+  bool isOperator() const noexcept;
+};
+
+// Outcome of the non-throwing parsing API. position is the char offset for
+// INCORRECT_LEXEME and INCORRECT_NUMBER and the lexeme index for
+// UNOPENED_PARENT, as in the messages thrown by ThrowError.
+struct ParseStatus {
+  enum ErrorCode code = NO_ERROR;
+  size_t position = 0;
+
+  bool isOk() const noexcept;
+  std::string Message() const;
+};
+
+std::string ErrorMessage(enum ErrorCode code, size_t position = 0);
+void ThrowError(enum ErrorCode code, size_t position = 0);
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_LEXEME_H_
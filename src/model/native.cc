@@ -0,0 +1,271 @@
+#include "native.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define S21_NATIVE_SUPPORTED 1
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+constexpr const char *kEntryPoint = "s21_evaluate_batch";
+constexpr const char *kCompilerFlags =
+    "-O3 -march=native -ffp-contract=off -shared -fPIC";
+
+std::string Temporary(uint32_t index) { return "t" + std::to_string(index); }
+
+std::string Literal(double value) {
+  if (std::isnan(value)) {
+    return "NAN";
+  } else if (std::isinf(value)) {
+    return value < 0 ? "-HUGE_VAL" : "HUGE_VAL";
+  }
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "%a", value);
+  return buffer;
+}
+
+std::string Expression(Instruction::OpCode op, const std::string &a,
+                       const std::string &b) {
+  switch (op) {
+    case Instruction::NEG:
+      return "-" + a;
+    case Instruction::COS:
+      return "cos(" + a + ")";
+    case Instruction::SIN:
+      return "sin(" + a + ")";
+    case Instruction::TAN:
+      return "tan(" + a + ")";
+    case Instruction::COTAN:
+      return "1 / tan(" + a + ")";
+    case Instruction::ACOS:
+      return "acos(" + a + ")";
+    case Instruction::ASIN:
+      return "asin(" + a + ")";
+    case Instruction::ATAN:
+      return "atan(" + a + ")";
+    case Instruction::SQRT:
+      return "sqrt(" + a + ")";
+    case Instruction::LN:
+      return "log(" + a + ")";
+    case Instruction::LOG:
+      return "log(" + a + ") / log(10)";
+    case Instruction::ADD:
+      return a + " + " + b;
+    case Instruction::SUB:
+      return a + " - " + b;
+    case Instruction::MUL:
+      return a + " * " + b;
+    case Instruction::DIV:
+      return a + " / " + b;
+    case Instruction::POW:
+      return "pow(" + a + ", " + b + ")";
+    case Instruction::MOD:
+      return "fmod(" + a + ", " + b + ")";
+    default:
+      return a;
+  }
+}
+
+std::string Hex(uint64_t value) {
+  char buffer[17];
+  std::snprintf(buffer, sizeof(buffer), "%016llx",
+                static_cast<unsigned long long>(value));
+  return buffer;
+}
+
+uint64_t Fnv1a(const std::string &text) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : text) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string ReadFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+bool WriteFile(const std::string &path, const std::string &content) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file << content;
+  return bool(file.flush());
+}
+
+std::string Quote(const std::string &text) {
+  std::string quoted = "'";
+  for (char c : text) {
+    quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+  }
+  return quoted + "'";
+}
+
+};  // namespace
+
+NativeProgram::NativeProgram(const Program &program,
+                             const std::string &expression) {
+#ifdef S21_NATIVE_SUPPORTED
+  namespace fs = std::filesystem;
+  std::error_code error;
+  fs::path directory = CacheDirectory();
+  fs::create_directories(directory, error);
+  if (error) {
+    return;
+  }
+  std::string source = GenerateSource(program);
+  std::string key = Hex(Fnv1a(NormalizeExpression(expression)));
+  std::string base = (directory / key).string();
+  // dlopen hands back an already loaded object with the same name, so every
+  // source revision gets its own file name.
+  std::string object = base + "." + Hex(Fnv1a(source)) + ".so";
+
+  from_cache_ = fs::exists(object, error) && ReadFile(base + ".c") == source;
+  if (!from_cache_) {
+    for (const fs::directory_entry &entry :
+         fs::directory_iterator(directory, error)) {
+      std::string name = entry.path().filename().string();
+      if (name.rfind(key + ".", 0) == 0 && entry.path().extension() == ".so") {
+        fs::remove(entry.path(), error);
+      }
+    }
+    std::string temporary = base + "." + std::to_string(getpid());
+    const char *compiler = std::getenv(kNativeCompilerVariable);
+    std::string command = std::string(compiler ? compiler : "cc") + " " +
+                          kCompilerFlags + " -o " + Quote(temporary + ".so") +
+                          " " + Quote(temporary + ".c") +
+                          " -lm >/dev/null 2>&1";
+    bool built = WriteFile(temporary + ".c", source) &&
+                 std::system(command.c_str()) == 0;
+    if (built) {
+      fs::rename(temporary + ".so", object, error);
+      built = !error;
+    }
+    if (built) {
+      fs::rename(temporary + ".c", base + ".c", error);
+    }
+    fs::remove(temporary + ".c", error);
+    fs::remove(temporary + ".so", error);
+    if (!built) {
+      return;
+    }
+  }
+
+  handle_ = dlopen(object.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (handle_) {
+    function_ = reinterpret_cast<Function>(dlsym(handle_, kEntryPoint));
+  }
+  if (!function_) {
+    Release();
+    return;
+  }
+  path_ = object;
+#else
+  (void)program;
+  (void)expression;
+#endif
+}
+
+NativeProgram::NativeProgram(NativeProgram &&other) noexcept {
+  *this = std::move(other);
+}
+
+NativeProgram &NativeProgram::operator=(NativeProgram &&other) noexcept {
+  if (this != &other) {
+    Release();
+    std::swap(handle_, other.handle_);
+    std::swap(function_, other.function_);
+    std::swap(from_cache_, other.from_cache_);
+    std::swap(path_, other.path_);
+  }
+  return *this;
+}
+
+NativeProgram::~NativeProgram() { Release(); }
+
+bool NativeProgram::isLoaded() const noexcept { return function_; }
+bool NativeProgram::isFromCache() const noexcept { return from_cache_; }
+const std::string &NativeProgram::Path() const noexcept { return path_; }
+
+void NativeProgram::EvaluateBatch(const double *xs, double *out,
+                                  size_t count) const {
+  function_(xs, out, count);
+}
+
+// Every instruction gets its own const temporary, so slot reuse in the
+// Program does not leak into the C code and the compiler sees plain SSA.
+std::string NativeProgram::GenerateSource(const Program &program) {
+  std::vector<std::string> slots(program.SlotCount());
+  std::string body;
+  uint32_t index = 0;
+  for (const Instruction &ins : program.Code()) {
+    std::string value;
+    if (ins.op == Instruction::LOAD_X) {
+      value = "xs[i]";
+    } else if (ins.op == Instruction::LOAD_CONST) {
+      value = Literal(program.Constants()[ins.a]);
+    } else {
+      value = Expression(ins.op, slots[ins.a],
+                         ins.isBinary() ? slots[ins.b] : std::string());
+    }
+    slots[ins.dst] = Temporary(index++);
+    body += "    const double " + slots[ins.dst] + " = " + value + ";\n";
+  }
+  std::string result =
+      program.isEmpty() ? std::string("0.0") : slots[program.Result()];
+  return std::string("/* generated by smartcalc */\n") +
+         "#include <math.h>\n#include <stddef.h>\n\n" + "void " +
+         kEntryPoint + "(const double *xs, double *out, size_t count) {\n" +
+         "  for (size_t i = 0; i < count; ++i) {\n" + body +
+         "    out[i] = " + result + ";\n  }\n}\n";
+}
+
+std::string NativeProgram::NormalizeExpression(const std::string &expression) {
+  std::string normalized;
+  for (char c : expression) {
+    if (!std::isspace(static_cast<unsigned char>(c))) {
+      normalized += c == 'X' ? 'x' : c;
+    }
+  }
+  return normalized;
+}
+
+std::string NativeProgram::CacheDirectory() {
+  if (const char *directory = std::getenv(kNativeCacheVariable)) {
+    return directory;
+  } else if (const char *cache = std::getenv("XDG_CACHE_HOME")) {
+    return std::string(cache) + "/smartcalc";
+  } else if (const char *home = std::getenv("HOME")) {
+    return std::string(home) + "/.cache/smartcalc";
+  }
+  return (std::filesystem::temp_directory_path() / "smartcalc").string();
+}
+
+void NativeProgram::Release() noexcept {
+#ifdef S21_NATIVE_SUPPORTED
+  if (handle_) {
+    dlclose(handle_);
+  }
+#endif
+  handle_ = nullptr;
+  function_ = nullptr;
+  from_cache_ = false;
+  path_.clear();
+}
+
+};  // namespace s21
@@ -0,0 +1,55 @@
+#ifndef SMARTCALC_MODEL_NATIVE_H_
+#define SMARTCALC_MODEL_NATIVE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "program.h"
+
+namespace s21 {
+
+// Ahead-of-time backend for long batch runs: the Program is printed as a C
+// loop, built with the system compiler into a shared object and loaded with
+// dlopen. Objects are cached on disk under a hash of the normalized
+// expression text next to the generated source, which is compared on reuse,
+// so a repeat run only pays for dlopen. The cache lives in
+// SMARTCALC_NATIVE_CACHE, $XDG_CACHE_HOME/smartcalc or ~/.cache/smartcalc;
+// the compiler is SMARTCALC_CC or cc. When any step fails isLoaded() is false
+// and callers keep using the Program.
+constexpr const char *kNativeCacheVariable = "SMARTCALC_NATIVE_CACHE";
+constexpr const char *kNativeCompilerVariable = "SMARTCALC_CC";
+
+class NativeProgram {
+ public:
+  NativeProgram() = default;
+  NativeProgram(const Program &program, const std::string &expression);
+  NativeProgram(NativeProgram &&other) noexcept;
+  NativeProgram &operator=(NativeProgram &&other) noexcept;
+  NativeProgram(const NativeProgram &) = delete;
+  NativeProgram &operator=(const NativeProgram &) = delete;
+  ~NativeProgram();
+
+  bool isLoaded() const noexcept;
+  bool isFromCache() const noexcept;
+  const std::string &Path() const noexcept;
+
+  void EvaluateBatch(const double *xs, double *out, size_t count) const;
+
+  static std::string GenerateSource(const Program &program);
+  static std::string NormalizeExpression(const std::string &expression);
+  static std::string CacheDirectory();
+
+ private:
+  using Function = void (*)(const double *xs, double *out, size_t count);
+
+  void Release() noexcept;
+
+  void *handle_ = nullptr;
+  Function function_ = nullptr;
+  bool from_cache_ = false;
+  std::string path_;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_NATIVE_H_
@@ -0,0 +1,226 @@
+#include "plot_worker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace s21 {
+
+PlotWorker::PlotWorker(size_t threads, std::shared_ptr<ExpressionCache> cache,
+                       std::shared_ptr<TileCache> tiles)
+    : PlotWorker(std::make_shared<ThreadPool>(threads), std::move(cache),
+                 std::move(tiles)) {}
+
+PlotWorker::PlotWorker(std::shared_ptr<ThreadPool> pool,
+                       std::shared_ptr<ExpressionCache> cache,
+                       std::shared_ptr<TileCache> tiles)
+    : tiles_(std::move(tiles)) {
+  model_.ShareSamplingPool(std::move(pool));
+  model_.ShareExpressionCache(std::move(cache));
+  thread_ = std::thread(&PlotWorker::Work, this);
+}
+
+PlotWorker::~PlotWorker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    cancel_ = true;
+  }
+  wake_.notify_all();
+  thread_.join();
+}
+
+void PlotWorker::SetCallback(Callback done) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  done_ = std::move(done);
+}
+
+size_t PlotWorker::Submit(PlotRequest request) {
+  size_t id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_) {
+      ++cancelled_;
+    }
+    pending_ = std::make_unique<PlotRequest>(std::move(request));
+    id = ++next_id_;
+    cancel_ = true;
+  }
+  wake_.notify_all();
+  return id;
+}
+
+void PlotWorker::Cancel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending_) {
+    pending_.reset();
+    ++cancelled_;
+  }
+  cancel_ = true;
+}
+
+size_t PlotWorker::Completed() const noexcept { return completed_; }
+
+size_t PlotWorker::Cancelled() const noexcept { return cancelled_; }
+
+std::shared_ptr<TileCache> PlotWorker::Tiles() const { return tiles_; }
+
+void PlotWorker::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [this] { return stop_ || pending_; });
+    if (stop_) {
+      break;
+    }
+    std::unique_ptr<PlotRequest> request = std::move(pending_);
+    size_t id = next_id_;
+    cancel_ = false;
+    lock.unlock();
+
+    PlotResult result = Run(id, std::move(*request));
+
+    lock.lock();
+    // Submit and Cancel set cancel_ under the lock, so a result checked here
+    // was not superseded before it is delivered.
+    if (cancel_) {
+      ++cancelled_;
+    } else {
+      ++completed_;
+      if (done_) {
+        done_(std::move(result));
+      }
+    }
+  }
+}
+
+PlotResult PlotWorker::Run(size_t id, PlotRequest request) {
+  PlotResult result;
+  result.id = id;
+  result.status = model_.Prepare(request.input);
+  if (result.status.isOk() && !request.input.empty()) {
+    const std::string &input = request.input;
+    double low_x = request.low_x, high_x = request.high_x;
+    SamplingOptions options = request.sampling;
+    options.cancel = &cancel_;
+    std::pair<std::vector<double>, std::vector<double>> xy;
+    if (!tiles_ ||
+        !SampleTiles(id, request, options, xy, result.evaluations)) {
+      xy = model_.CalculateAdaptive(input, low_x, high_x, request.low_y,
+                                    request.high_y, options);
+      result.evaluations += model_.LastEvaluationCount();
+    }
+    if (!request.sink) {
+      result.x = std::move(xy.first);
+      result.y = std::move(xy.second);
+    } else if (!cancel_) {
+      request.sink(xy.first.data(), xy.second.data(), xy.first.size());
+    }
+    if (request.range && !cancel_) {
+      result.range = model_.EstimateRange(input, low_x, high_x);
+    }
+    if (request.markers && !cancel_) {
+      result.roots = model_.FindRoots(input, low_x, high_x);
+    }
+    if (request.markers && !cancel_) {
+      result.extrema = model_.FindExtrema(input, low_x, high_x);
+    }
+    if (request.integral && !cancel_) {
+      result.integral = model_.Integrate(input, low_x, high_x);
+    }
+  }
+  result.request = std::move(request);
+  return result;
+}
+
+// Tiles are sampled without y clipping, so that they serve any y range, but
+// with the vertical scale of the view, as the untiled path would, and every
+// tile as tile_pixels pixels at the view's density of points. Without y
+// limits the scale comes from the spread of the first view at the level,
+// rounded to a power of two, and the cache keeps it for the views after it,
+// so that pans neither evaluate the whole view for it nor change the tiles'
+// key. Clipping is applied to the assembled curve. False when the view
+// cannot be tiled.
+bool PlotWorker::SampleTiles(
+    size_t id, const PlotRequest &request, const SamplingOptions &options,
+    std::pair<std::vector<double>, std::vector<double>> &xy,
+    size_t &evaluations) {
+  double low_x = request.low_x, high_x = request.high_x;
+  double units_per_pixel = (high_x - low_x) / options.width;
+  if (!(units_per_pixel > 0) || !std::isfinite(units_per_pixel)) {
+    return false;
+  }
+  int level = tiles_->Level(units_per_pixel);
+  double share = tiles_->TilePixels() / options.width;
+  SamplingOptions tile = options;
+  tile.width = tiles_->TilePixels();
+  tile.max_points =
+      std::max<size_t>(std::ceil(options.max_points * share), 2);
+  tile.initial_points = std::clamp<size_t>(
+      std::ceil(options.initial_points * share), 2, tile.max_points);
+  std::string expression = ExpressionCache::Normalize(request.input);
+  bool clipped = request.low_y != 0 || request.high_y != 0;
+  auto rounded = [&options](const std::vector<double> &grid, double low_y,
+                            double high_y) {
+    double scale = AdaptiveSampler(options).VerticalScale(grid, low_y, high_y);
+    return std::exp2(std::round(std::log2(scale)));
+  };
+  auto spread = [&] {
+    std::vector<double> grid =
+        model_.Calculate(request.input, low_x, high_x, 0, 0,
+                         std::max<size_t>(options.initial_points, 2))
+            .second;
+    evaluations += model_.LastEvaluationCount();
+    return rounded(grid, 0, 0);
+  };
+  tile.scale = clipped ? rounded({}, request.low_y, request.high_y)
+                       : tiles_->Scale(expression, tile, level, spread);
+  auto sample = [&](double low, double high, const SamplingOptions &sampling,
+                    TileCache::Tile &out) {
+    auto samples =
+        model_.CalculateAdaptive(request.input, low, high, 0, 0, sampling);
+    evaluations += model_.LastEvaluationCount();
+    out.x = std::move(samples.first);
+    out.y = std::move(samples.second);
+    return !cancel_;
+  };
+  auto clip = [&request, clipped](std::vector<double> &ys) {
+    if (clipped) {
+      for (double &y : ys) {
+        if (!(y >= request.low_y && y <= request.high_y)) y = NAN;
+      }
+    }
+  };
+
+  std::vector<int64_t> missing;
+  if (!tiles_->Assemble(expression, tile, low_x, high_x, level, sample, xy,
+                        &missing)) {
+    return false;
+  }
+  bool shown = std::any_of(xy.second.begin(), xy.second.end(),
+                           [](double y) { return !std::isnan(y); });
+  if (!missing.empty() && shown) {
+    PlotResult provisional;
+    provisional.id = id;
+    provisional.provisional = true;
+    provisional.request = request;
+    provisional.x = std::move(xy.first);
+    provisional.y = std::move(xy.second);
+    clip(provisional.y);
+    Deliver(std::move(provisional));
+  }
+  if (!missing.empty()) {
+    tiles_->Refill(expression, tile, low_x, high_x, level, sample, xy);
+  }
+  clip(xy.second);
+  return true;
+}
+
+// A provisional result: dropped when superseded, and not counted.
+void PlotWorker::Deliver(PlotResult &&result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!cancel_ && done_) {
+    done_(std::move(result));
+  }
+}
+
+};  // namespace s21
@@ -0,0 +1,121 @@
+#ifndef SMARTCALC_MODEL_PLOT_WORKER_H_
+#define SMARTCALC_MODEL_PLOT_WORKER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "calculator.h"
+#include "tile_cache.h"
+
+namespace s21 {
+
+// Everything drawn for one expression: the curve over [low_x, high_x], with
+// low_y == high_y == 0 meaning no y clipping, and optionally its y range
+// estimate, roots, extrema and integral over the same x range. These go over
+// the whole range every time, so a view that only moved leaves them off and
+// costs no more than the tiles it newly shows.
+struct PlotRequest {
+  // When set, receives the curve's samples, ascending in x, on the worker
+  // thread instead of PlotResult::x and y, so a consumer can build its own
+  // storage in one pass and take it over without further copies.
+  using Sink =
+      std::function<void(const double *xs, const double *ys, size_t count)>;
+
+  std::string input;
+  double low_x = 0;
+  double high_x = 0;
+  double low_y = 0;
+  double high_y = 0;
+  SamplingOptions sampling;
+  bool range = true;
+  bool markers = true;
+  bool integral = true;
+  Sink sink;
+};
+
+struct PlotResult {
+  size_t id = 0;
+  // Sent ahead of the result proper, with the same id, when the curve is
+  // tiled and some tiles are not cached: those are shown from other levels
+  // or left out. Only x and y are set, whether the request has a sink or not.
+  bool provisional = false;
+  PlotRequest request;
+  ParseStatus status;
+  std::vector<double> x;
+  std::vector<double> y;
+  // Points the curve was evaluated at to sample it; cached tiles take none.
+  size_t evaluations = 0;
+  Interval range = Interval::Empty();
+  std::vector<double> roots;
+  std::vector<Extremum> extrema;
+  Integral integral;
+};
+
+// Computes plots on one background thread, latest request wins: Submit
+// cancels the request in flight, which stops between sampling batches and
+// between stages, and replaces one that has not started yet. Only results
+// of requests that were not superseded reach the callback. It runs on the
+// worker thread with the worker locked, so it must not call back into it;
+// after SetCallback returns the previous one is no longer called.
+//
+// With a tile cache, curves are sampled by tiles of the level that suits
+// the view, and only tiles not sampled before are evaluated.
+class PlotWorker {
+ public:
+  using Callback = std::function<void(PlotResult &&result)>;
+
+  explicit PlotWorker(size_t threads = 0,
+                      std::shared_ptr<ExpressionCache> cache =
+                          ExpressionCache::Shared(),
+                      std::shared_ptr<TileCache> tiles = nullptr);
+  // Samples on pool, shared with other models, instead of a pool of its own.
+  explicit PlotWorker(std::shared_ptr<ThreadPool> pool,
+                      std::shared_ptr<ExpressionCache> cache =
+                          ExpressionCache::Shared(),
+                      std::shared_ptr<TileCache> tiles = nullptr);
+  ~PlotWorker();
+  PlotWorker(const PlotWorker &) = delete;
+  PlotWorker &operator=(const PlotWorker &) = delete;
+
+  void SetCallback(Callback done);
+  // Id of the request, increasing with every call.
+  size_t Submit(PlotRequest request);
+  void Cancel();
+
+  size_t Completed() const noexcept;
+  size_t Cancelled() const noexcept;
+  std::shared_ptr<TileCache> Tiles() const;
+
+ private:
+  void Work();
+  PlotResult Run(size_t id, PlotRequest request);
+  bool SampleTiles(size_t id, const PlotRequest &request,
+                   const SamplingOptions &options,
+                   std::pair<std::vector<double>, std::vector<double>> &xy,
+                   size_t &evaluations);
+  void Deliver(PlotResult &&result);
+
+  CalculatorModel model_;
+  std::shared_ptr<TileCache> tiles_;
+  Callback done_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::unique_ptr<PlotRequest> pending_;
+  size_t next_id_ = 0;
+  bool stop_ = false;
+  std::atomic<bool> cancel_{false};
+  std::atomic<size_t> completed_{0};
+  std::atomic<size_t> cancelled_{0};
+  std::thread thread_;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_PLOT_WORKER_H_
@@ -0,0 +1,262 @@
+#include "program.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "dag.h"
+#include "dispatch.h"
+#include "kernels.h"
+
+namespace s21 {
+
+bool Instruction::isUnary() const noexcept { return Arity(op) == 1; }
+bool Instruction::isBinary() const noexcept { return Arity(op) == 2; }
+
+size_t Instruction::Arity(OpCode op) noexcept {
+  if (op == LOAD_X || op == LOAD_CONST) {
+    return 0;
+  } else if (op >= ADD && op < OPCODE_END) {
+    return 2;
+  }
+  return 1;
+}
+
+void Program::Clear() noexcept {
+  code_.clear();
+  constants_.clear();
+  depth_ = 0;
+  slot_count_ = 0;
+  result_ = 0;
+}
+
+void Program::PushX() {
+  code_.push_back({Instruction::LOAD_X, Allocate(), 0, 0});
+}
+
+void Program::PushConstant(double value) {
+  uint32_t index = constants_.size();
+  constants_.push_back(value);
+  code_.push_back({Instruction::LOAD_CONST, Allocate(), index, 0});
+}
+
+bool Program::Apply(Instruction::OpCode op) {
+  size_t arity = Instruction::Arity(op);
+  if (depth_ < arity) {
+    return false;
+  }
+  if (op == Instruction::NOP) {
+    return true;
+  }
+  uint32_t a = depth_ - arity;
+  uint32_t b = arity == 2 ? a + 1 : 0;
+  depth_ -= arity;
+  code_.push_back({op, Allocate(), a, b});
+  return true;
+}
+
+uint32_t Program::AddConstant(double value) {
+  constants_.push_back(value);
+  return constants_.size() - 1;
+}
+
+void Program::Append(const Instruction &ins) {
+  code_.push_back(ins);
+  if (ins.dst >= slot_count_) {
+    slot_count_ = ins.dst + 1;
+  }
+}
+
+void Program::SetResult(uint32_t slot) noexcept { result_ = slot; }
+uint32_t Program::Result() const noexcept { return result_; }
+
+bool Program::isEmpty() const noexcept { return code_.empty(); }
+bool Program::isComplete() const noexcept { return depth_ <= 1; }
+
+bool Program::isConstant() const noexcept {
+  return code_.empty() ||
+         (code_.size() == 1 && code_[0].op == Instruction::LOAD_CONST);
+}
+
+size_t Program::SlotCount() const noexcept { return slot_count_; }
+
+const std::vector<Instruction> &Program::Code() const noexcept {
+  return code_;
+}
+
+const std::vector<double> &Program::Constants() const noexcept {
+  return constants_;
+}
+
+double Program::Evaluate(double x) const {
+  if (slot_count_ <= kInlineSlots) {
+    double slots[kInlineSlots];
+    return Evaluate(x, slots);
+  }
+  std::vector<double> slots(slot_count_);
+  return Evaluate(x, slots.data());
+}
+
+double Program::Evaluate(double x, double *slots) const noexcept {
+  if (code_.empty()) return 0;
+  for (const Instruction &ins : code_) {
+    if (ins.op == Instruction::LOAD_X) {
+      slots[ins.dst] = x;
+    } else if (ins.op == Instruction::LOAD_CONST) {
+      slots[ins.dst] = constants_[ins.a];
+    } else {
+      slots[ins.dst] = ApplyScalar(ins.op, slots[ins.a], slots[ins.b]);
+    }
+  }
+  return slots[result_];
+}
+
+void Program::EvaluateBatch(const double *xs, double *out, size_t count,
+                            const kernels::KernelTable *table) const {
+  if (isConstant()) {
+    std::fill(out, out + count, code_.empty() ? 0.0 : constants_[code_[0].a]);
+    return;
+  }
+  if (!table) {
+    table = &dispatch::Active();
+  }
+  std::vector<double> columns(slot_count_ * kBatchBlock);
+  for (size_t offset = 0; offset < count; offset += kBatchBlock) {
+    size_t block = std::min(kBatchBlock, count - offset);
+    EvaluateBlock(xs + offset, out + offset, block, columns.data(), *table);
+  }
+}
+
+void Program::EvaluateBlock(const double *xs, double *out, size_t count,
+                            double *columns,
+                            const kernels::KernelTable &table) const noexcept {
+  for (const Instruction &ins : code_) {
+    double *dst = columns + ins.dst * kBatchBlock;
+    const double *a = columns + ins.a * kBatchBlock;
+    const double *b = columns + ins.b * kBatchBlock;
+    switch (ins.op) {
+      case Instruction::LOAD_X:
+        std::copy(xs, xs + count, dst);
+        break;
+      case Instruction::LOAD_CONST:
+        std::fill(dst, dst + count, constants_[ins.a]);
+        break;
+      default:
+        if (ins.isBinary()) {
+          table.binary[ins.op](a, b, dst, count);
+        } else {
+          table.unary[ins.op](a, dst, count);
+        }
+        break;
+    }
+  }
+  const double *result = columns + result_ * kBatchBlock;
+  std::copy(result, result + count, out);
+}
+
+// Values that do not depend on x stay on a shadow stack until something
+// x-dependent is pushed above them; from then on they can never be folded and
+// are emitted as constants.
+Program Program::FoldConstants() const {
+  struct Entry {
+    bool emitted;
+    double value;
+  };
+  Program folded;
+  std::vector<Entry> stack;
+  size_t emitted = 0;
+  auto materialize = [&]() {
+    for (; emitted < stack.size(); ++emitted) {
+      folded.PushConstant(stack[emitted].value);
+      stack[emitted].emitted = true;
+    }
+  };
+
+  for (const Instruction &ins : code_) {
+    if (ins.op == Instruction::LOAD_CONST) {
+      stack.push_back({false, constants_[ins.a]});
+    } else if (ins.op == Instruction::LOAD_X) {
+      materialize();
+      folded.PushX();
+      stack.push_back({true, 0});
+      ++emitted;
+    } else {
+      size_t arity = Instruction::Arity(ins.op);
+      auto operands = stack.end() - arity;
+      bool constant = true;
+      for (auto it = operands; it != stack.end(); ++it) {
+        constant = constant && !it->emitted;
+      }
+      if (constant) {
+        double b = arity == 2 ? operands[1].value : 0;
+        double value = ApplyScalar(ins.op, operands[0].value, b);
+        stack.erase(operands, stack.end());
+        stack.push_back({false, value});
+      } else {
+        materialize();
+        folded.Apply(ins.op);
+        stack.erase(operands, stack.end());
+        stack.push_back({true, 0});
+        emitted = stack.size();
+      }
+    }
+  }
+  materialize();
+  return folded;
+}
+
+Program Program::EliminateCommonSubexpressions() const {
+  return ExpressionDag(*this).Schedule();
+}
+
+double Program::ApplyScalar(Instruction::OpCode op, double a,
+                            double b) noexcept {
+  switch (op) {
+    case Instruction::NEG:
+      return -a;
+    case Instruction::COS:
+      return ::cos(a);
+    case Instruction::SIN:
+      return ::sin(a);
+    case Instruction::TAN:
+      return ::tan(a);
+    case Instruction::COTAN:
+      return 1 / ::tan(a);
+    case Instruction::ACOS:
+      return ::acos(a);
+    case Instruction::ASIN:
+      return ::asin(a);
+    case Instruction::ATAN:
+      return ::atan(a);
+    case Instruction::SQRT:
+      return ::sqrt(a);
+    case Instruction::LN:
+      return ::log(a);
+    case Instruction::LOG:
+      return ::log(a) / ::log(10);
+    case Instruction::ADD:
+      return a + b;
+    case Instruction::SUB:
+      return a - b;
+    case Instruction::MUL:
+      return a * b;
+    case Instruction::DIV:
+      return a / b;
+    case Instruction::POW:
+      return ::pow(a, b);
+    case Instruction::MOD:
+      return fmod(a, b);
+    default:
+      return a;
+  }
+}
+
+uint32_t Program::Allocate() {
+  uint32_t slot = depth_++;
+  if (depth_ > slot_count_) {
+    slot_count_ = depth_;
+  }
+  return slot;
+}
+
+};  // namespace s21
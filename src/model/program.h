@@ -0,0 +1,102 @@
+#ifndef SMARTCALC_MODEL_PROGRAM_H_
+#define SMARTCALC_MODEL_PROGRAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace s21 {
+
+namespace kernels {
+struct KernelTable;
+};  // namespace kernels
+
+struct Instruction {
+  enum OpCode : uint8_t {
+    NOP,
+    LOAD_X,
+    LOAD_CONST,
+    NEG,
+    COS,
+    SIN,
+    TAN,
+    COTAN,
+    ACOS,
+    ASIN,
+    ATAN,
+    SQRT,
+    LN,
+    LOG,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    POW,
+    MOD,
+    OPCODE_END,
+  };
+
+  OpCode op = NOP;
+  uint32_t dst = 0;
+  uint32_t a = 0;
+  uint32_t b = 0;
+
+  bool isUnary() const noexcept;
+  bool isBinary() const noexcept;
+  static size_t Arity(OpCode op) noexcept;
+};
+
+// Flat register form of an rpn expression: every instruction reads its
+// operands from slots and writes one slot, constants live in a pool indexed by
+// LOAD_CONST. PushX/PushConstant/Apply build it in stack order (slot = stack
+// depth, result in slot 0); Append places instructions in arbitrary slots.
+class Program {
+ public:
+  void Clear() noexcept;
+
+  void PushX();
+  void PushConstant(double value);
+  bool Apply(Instruction::OpCode op);
+
+  uint32_t AddConstant(double value);
+  void Append(const Instruction &ins);
+  void SetResult(uint32_t slot) noexcept;
+  uint32_t Result() const noexcept;
+
+  bool isEmpty() const noexcept;
+  bool isComplete() const noexcept;
+  bool isConstant() const noexcept;
+  size_t SlotCount() const noexcept;
+  const std::vector<Instruction> &Code() const noexcept;
+  const std::vector<double> &Constants() const noexcept;
+
+  double Evaluate(double x) const;
+  double Evaluate(double x, double *slots) const noexcept;
+  void EvaluateBatch(const double *xs, double *out, size_t count,
+                     const kernels::KernelTable *table = nullptr) const;
+
+  Program FoldConstants() const;
+  Program EliminateCommonSubexpressions() const;
+
+  static double ApplyScalar(Instruction::OpCode op, double a,
+                            double b = 0) noexcept;
+
+ private:
+  static constexpr size_t kInlineSlots = 64;
+  static constexpr size_t kBatchBlock = 256;
+
+  uint32_t Allocate();
+  void EvaluateBlock(const double *xs, double *out, size_t count,
+                     double *columns,
+                     const kernels::KernelTable &table) const noexcept;
+
+  std::vector<Instruction> code_;
+  std::vector<double> constants_;
+  size_t depth_ = 0;
+  size_t slot_count_ = 0;
+  uint32_t result_ = 0;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_PROGRAM_H_
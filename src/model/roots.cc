@@ -0,0 +1,148 @@
+#include "roots.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace s21 {
+
+namespace {
+
+struct Bracket {
+  double low, high;
+  double low_value, high_value;
+};
+
+double Order(const Dual &d, int order) { return order ? d.first : d.value; }
+
+double Slope(const Dual &d, int order) { return order ? d.second : d.first; }
+
+};  // namespace
+
+RootFinder::RootFinder(const CompiledExpression &expression, ThreadPool *pool,
+                       size_t samples)
+    : expression_(expression),
+      pool_(pool),
+      samples_(std::max<size_t>(samples, 2)) {}
+
+std::vector<double> RootFinder::FindRoots(double low_x, double high_x) const {
+  return FindZeros(low_x, high_x, 0);
+}
+
+std::vector<Extremum> RootFinder::FindExtrema(double low_x,
+                                              double high_x) const {
+  std::vector<Extremum> extrema;
+  double h = (high_x - low_x) / (samples_ - 1) / 2;
+  for (double x : FindZeros(low_x, high_x, 1)) {
+    double y = expression_.Evaluate(x);
+    double left = expression_.Evaluate(x - h);
+    double right = expression_.Evaluate(x + h);
+    if (y >= left && y >= right) {
+      extrema.push_back({x, y, true});
+    } else if (y <= left && y <= right) {
+      extrema.push_back({x, y, false});
+    }
+  }
+  return extrema;
+}
+
+std::vector<double> RootFinder::FindZeros(double low_x, double high_x,
+                                          int order) const {
+  size_t n = samples_;
+  std::vector<double> xs(n), values(n), slopes(n);
+  for (size_t i = 0; i < n; ++i) {
+    xs[i] = i + 1 == n ? high_x : low_x + (high_x - low_x) * i / (n - 1);
+  }
+  double *first = order ? slopes.data() : nullptr;
+  if (pool_) {
+    expression_.EvaluateDerivatives(xs.data(), values.data(), first, nullptr,
+                                    n, *pool_, n / pool_->ThreadCount() + 1);
+  } else {
+    expression_.EvaluateDerivatives(xs.data(), values.data(), first, nullptr,
+                                    n);
+  }
+  const std::vector<double> &g = order ? slopes : values;
+
+  std::vector<double> zeros;
+  std::vector<Bracket> brackets;
+  for (size_t i = 0; i < n; ++i) {
+    if (g[i] == 0 && std::isfinite(values[i])) {
+      zeros.push_back(xs[i]);
+    } else if (i + 1 < n && g[i] * g[i + 1] < 0) {
+      brackets.push_back({xs[i], xs[i + 1], g[i], g[i + 1]});
+    }
+  }
+
+  std::vector<double> refined(brackets.size(), NAN);
+  auto refine = [&](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k) {
+      const Bracket &bracket = brackets[k];
+      double x = Refine(bracket.low, bracket.high, bracket.low_value, order);
+      Dual d = At(x);
+      // Across a pole or a step the bracket collapses onto a value that is
+      // not small next to those at its ends.
+      double limit = std::max(std::fabs(bracket.low_value),
+                              std::fabs(bracket.high_value));
+      if (std::isfinite(d.value) &&
+          std::fabs(Order(d, order)) <= kResidual * limit) {
+        refined[k] = x;
+      }
+    }
+  };
+  if (pool_) {
+    pool_->ParallelFor(brackets.size(), 1, refine);
+  } else {
+    refine(0, brackets.size());
+  }
+  for (double x : refined) {
+    if (!std::isnan(x)) zeros.push_back(x);
+  }
+  std::sort(zeros.begin(), zeros.end());
+  zeros.erase(std::unique(zeros.begin(), zeros.end()), zeros.end());
+  return zeros;
+}
+
+// Safeguarded Newton: the bracket shrinks around the sign change on every
+// step, and a Newton step is only taken when it stays inside and at least
+// halves the previous step.
+double RootFinder::Refine(double low, double high, double low_value,
+                          int order) const {
+  double x = low + (high - low) / 2;
+  double previous = high - low, step = previous;
+  for (size_t i = 0; i < kMaxIterations; ++i) {
+    Dual d = At(x);
+    double g = Order(d, order);
+    if (g == 0 || std::isnan(g)) {
+      break;
+    } else if ((g < 0) == (low_value < 0)) {
+      low = x;
+    } else {
+      high = x;
+    }
+    double newton = x - g / Slope(d, order);
+    if (newton > low && newton < high &&
+        std::fabs(newton - x) * 2 <= previous) {
+      previous = step;
+      step = std::fabs(newton - x);
+      x = newton;
+    } else {
+      previous = step;
+      step = (high - low) / 2;
+      x = low + step;
+    }
+    double tolerance = 2 * DBL_EPSILON * std::fabs(x) + DBL_TRUE_MIN;
+    if (step <= tolerance || high - low <= tolerance) {
+      break;
+    }
+  }
+  return x;
+}
+
+Dual RootFinder::At(double x) const {
+  Dual d;
+  EvaluateDerivatives(expression_.Code(), &x, &d.value, &d.first, &d.second,
+                      1);
+  return d;
+}
+
+};  // namespace s21
@@ -0,0 +1,51 @@
+#ifndef SMARTCALC_MODEL_ROOTS_H_
+#define SMARTCALC_MODEL_ROOTS_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "expression.h"
+#include "thread_pool.h"
+
+namespace s21 {
+
+struct Extremum {
+  double x = 0;
+  double y = 0;
+  bool maximum = false;
+};
+
+// Finds where a curve crosses zero, or where its slope does, on [low_x,
+// high_x]. A uniform grid of samples points is evaluated in parallel and every
+// sign change between neighbours becomes a bracket; the brackets are then
+// refined concurrently by Newton steps on exact derivatives, falling back to
+// bisection whenever a step leaves the bracket or converges too slowly.
+// Sign changes across poles and steps are recognised and dropped. Roots that
+// only touch zero without crossing it are not found.
+class RootFinder {
+ public:
+  static constexpr size_t kSamples = 4096;
+  static constexpr size_t kMaxIterations = 100;
+  static constexpr double kResidual = 1e-6;
+
+  explicit RootFinder(const CompiledExpression &expression,
+                      ThreadPool *pool = nullptr, size_t samples = kSamples);
+
+  std::vector<double> FindRoots(double low_x, double high_x) const;
+  std::vector<Extremum> FindExtrema(double low_x, double high_x) const;
+
+ private:
+  // order 0 looks for zeros of f, order 1 for zeros of f'.
+  std::vector<double> FindZeros(double low_x, double high_x,
+                                int order) const;
+  double Refine(double low, double high, double low_value, int order) const;
+  Dual At(double x) const;
+
+  const CompiledExpression &expression_;
+  ThreadPool *pool_;
+  size_t samples_;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_ROOTS_H_
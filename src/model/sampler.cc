@@ -0,0 +1,281 @@
+#include "sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace s21 {
+
+namespace {
+
+constexpr double kBreakJump = 0.125;
+constexpr size_t kProbeDepth = 12;
+
+struct Probe {
+  size_t index;
+  double left_x, left_y, right_x, right_y;
+  double initial_jump;
+  double nan_x = NAN;
+  bool active = true;
+};
+
+};  // namespace
+
+// Only intervals wider than a pixel are halved, so the finest are over half
+// a pixel wide.
+SamplingOptions ViewportSampling(double width, double height,
+                                 double pixel_ratio, size_t max_points) {
+  SamplingOptions options;
+  pixel_ratio = pixel_ratio > 0 ? pixel_ratio : 1;
+  options.width = std::max(width * pixel_ratio, 1.0);
+  options.height = std::max(height * pixel_ratio, 1.0);
+  options.min_spacing = 1;
+  options.max_points = std::min<size_t>(
+      max_points, 2 * static_cast<size_t>(std::ceil(options.width)));
+  options.initial_points =
+      std::min(options.initial_points, options.max_points);
+  return options;
+}
+
+AdaptiveSampler::AdaptiveSampler(const SamplingOptions &options)
+    : options_(options) {}
+
+std::pair<std::vector<double>, std::vector<double>> AdaptiveSampler::Sample(
+    const Evaluator &evaluate, double low_x, double high_x, double low_y,
+    double high_y, const Enclosure &enclose) {
+  constexpr double kUnbounded = std::numeric_limits<double>::infinity();
+  size_t n = std::max<size_t>(options_.initial_points, 2);
+  std::vector<double> xs(n), ys(n);
+  for (size_t i = 0; i < n; ++i) {
+    xs[i] = low_x + (high_x - low_x) * (double(i) / (n - 1));
+  }
+  evaluate(xs.data(), ys.data(), n);
+  evaluations_ = n;
+
+  double scale = VerticalScale(ys, low_y, high_y);
+  // Pixel error of every interval's chord, 0 once it is fine enough.
+  std::vector<double> error(n - 1, kUnbounded);
+  bool refine = std::isfinite(high_x - low_x) && high_x > low_x;
+  double pixel = options_.width > 0 ? (high_x - low_x) / options_.width : 0;
+  double min_width = pixel * options_.min_spacing;
+  bool clip = low_y != 0 || high_y != 0;
+  auto hidden = [&](double y) {
+    return std::isnan(y) || (clip && !(y >= low_y && y <= high_y));
+  };
+  auto invisible = [&](size_t i) {
+    if (!enclose || !hidden(ys[i]) || !hidden(ys[i + 1])) return false;
+    Interval y = enclose(xs[i], xs[i + 1]);
+    return y.isEmpty() || (clip && (y.high < low_y || y.low > high_y));
+  };
+
+  for (size_t depth = 0;
+       refine && depth < options_.max_depth && !isCancelled(); ++depth) {
+    std::vector<size_t> split;
+    for (size_t i = 0; i + 1 < xs.size(); ++i) {
+      double middle = xs[i] + (xs[i + 1] - xs[i]) / 2;
+      if (error[i] > options_.tolerance && xs[i + 1] - xs[i] > min_width &&
+          middle > xs[i] && middle < xs[i + 1]) {
+        if (invisible(i)) {
+          error[i] = 0;
+        } else {
+          split.push_back(i);
+        }
+      }
+    }
+    size_t budget = options_.max_points > evaluations_
+                        ? options_.max_points - evaluations_
+                        : 0;
+    if (split.size() > budget) {
+      std::nth_element(split.begin(), split.begin() + budget, split.end(),
+                       [&](size_t a, size_t b) { return error[a] > error[b]; });
+      split.resize(budget);
+      std::sort(split.begin(), split.end());
+      refine = false;
+    }
+    if (split.empty()) {
+      break;
+    }
+
+    std::vector<double> middle_x(split.size()), middle_y(split.size());
+    for (size_t k = 0; k < split.size(); ++k) {
+      size_t i = split[k];
+      middle_x[k] = xs[i] + (xs[i + 1] - xs[i]) / 2;
+    }
+    evaluate(middle_x.data(), middle_y.data(), split.size());
+    evaluations_ += split.size();
+
+    std::vector<double> next_x, next_y, next_error;
+    next_x.reserve(xs.size() + split.size());
+    next_y.reserve(xs.size() + split.size());
+    next_error.reserve(error.size() + split.size());
+    for (size_t i = 0, k = 0; i < xs.size(); ++i) {
+      next_x.push_back(xs[i]);
+      next_y.push_back(ys[i]);
+      if (i + 1 == xs.size()) {
+        break;
+      } else if (k < split.size() && split[k] == i) {
+        double e = Deviation(ys[i], middle_y[k], ys[i + 1], scale);
+        e = e > options_.tolerance ? e : 0;
+        next_x.push_back(middle_x[k]);
+        next_y.push_back(middle_y[k]);
+        next_error.push_back(e);
+        next_error.push_back(e);
+        ++k;
+      } else {
+        next_error.push_back(error[i]);
+      }
+    }
+    xs.swap(next_x);
+    ys.swap(next_y);
+    error.swap(next_error);
+  }
+
+  if (options_.detect_breaks && !isCancelled()) {
+    InsertBreaks(evaluate, scale, xs, ys);
+  }
+  if (low_y != 0 || high_y != 0) {
+    for (double &y : ys) {
+      if (!(y >= low_y && y <= high_y)) {
+        y = NAN;
+      }
+    }
+  }
+  return std::pair<std::vector<double>, std::vector<double>>(std::move(xs),
+                                                             std::move(ys));
+}
+
+size_t AdaptiveSampler::Evaluations() const noexcept { return evaluations_; }
+
+bool AdaptiveSampler::isCancelled() const noexcept {
+  return options_.cancel && options_.cancel->load(std::memory_order_relaxed);
+}
+
+void AdaptiveSampler::InsertBreaks(const Evaluator &evaluate, double scale,
+                                   std::vector<double> &xs,
+                                   std::vector<double> &ys) {
+  double threshold = kBreakJump * (options_.height > 0 ? options_.height : 1);
+  std::vector<Probe> probes;
+  for (size_t i = 0; i + 1 < xs.size(); ++i) {
+    double jump = std::fabs(ys[i + 1] - ys[i]) * scale;
+    if (std::isfinite(jump) && jump > threshold) {
+      probes.push_back({i, xs[i], ys[i], xs[i + 1], ys[i + 1], jump});
+    }
+  }
+  // A view whose points all went to refinement still separates its breaks.
+  size_t budget = options_.max_points > evaluations_
+                      ? (options_.max_points - evaluations_) / kProbeDepth
+                      : 0;
+  budget = std::max(budget, static_cast<size_t>(std::ceil(options_.width / 2)));
+  if (probes.size() > budget) {
+    std::nth_element(probes.begin(), probes.begin() + budget, probes.end(),
+                     [](const Probe &a, const Probe &b) {
+                       return a.initial_jump > b.initial_jump;
+                     });
+    probes.resize(budget);
+    std::sort(probes.begin(), probes.end(),
+              [](const Probe &a, const Probe &b) { return a.index < b.index; });
+  }
+
+  std::vector<double> middle_x, middle_y;
+  std::vector<Probe *> active;
+  for (size_t depth = 0; depth < kProbeDepth; ++depth) {
+    middle_x.clear();
+    active.clear();
+    for (Probe &probe : probes) {
+      double middle = probe.left_x + (probe.right_x - probe.left_x) / 2;
+      if (probe.active && middle > probe.left_x && middle < probe.right_x) {
+        middle_x.push_back(middle);
+        active.push_back(&probe);
+      }
+    }
+    if (active.empty() || isCancelled()) {
+      break;
+    }
+    middle_y.resize(middle_x.size());
+    evaluate(middle_x.data(), middle_y.data(), middle_x.size());
+    evaluations_ += middle_x.size();
+    for (size_t k = 0; k < active.size(); ++k) {
+      Probe &probe = *active[k];
+      if (!std::isfinite(middle_y[k])) {
+        probe.nan_x = middle_x[k];
+        probe.active = false;
+      } else if (std::fabs(middle_y[k] - probe.left_y) >=
+                 std::fabs(probe.right_y - middle_y[k])) {
+        probe.right_x = middle_x[k];
+        probe.right_y = middle_y[k];
+      } else {
+        probe.left_x = middle_x[k];
+        probe.left_y = middle_y[k];
+      }
+    }
+  }
+
+  std::vector<double> next_x, next_y;
+  next_x.reserve(xs.size() + 3 * probes.size());
+  next_y.reserve(ys.size() + 3 * probes.size());
+  auto push = [&](double x, double y) {
+    next_x.push_back(x);
+    next_y.push_back(std::isfinite(y) ? y : NAN);
+  };
+  for (size_t i = 0, k = 0; i < xs.size(); ++i) {
+    push(xs[i], ys[i]);
+    if (k == probes.size() || probes[k].index != i) {
+      continue;
+    }
+    const Probe &probe = probes[k++];
+    bool exit = !std::isnan(probe.nan_x);
+    double jump = std::fabs(probe.right_y - probe.left_y) * scale;
+    if (!exit && jump <= probe.initial_jump / 4) {
+      continue;
+    }
+    if (probe.left_x > xs[i]) push(probe.left_x, probe.left_y);
+    push(exit ? probe.nan_x : probe.left_x + (probe.right_x - probe.left_x) / 2,
+         NAN);
+    if (probe.right_x < xs[i + 1]) push(probe.right_x, probe.right_y);
+  }
+  xs.swap(next_x);
+  ys.swap(next_y);
+}
+
+// Pixels per unit of y: the one given, or from the visible range when one
+// is set, otherwise from the 5..95 percentile spread of the grid, so that
+// poles do not flatten the rest of the curve.
+double AdaptiveSampler::VerticalScale(const std::vector<double> &ys,
+                                      double low_y, double high_y) const {
+  if (options_.scale > 0) {
+    return options_.scale;
+  }
+  double span = high_y - low_y;
+  if (low_y == 0 && high_y == 0) {
+    std::vector<double> finite;
+    for (double y : ys) {
+      if (std::isfinite(y)) finite.push_back(y);
+    }
+    span = 0;
+    if (!finite.empty()) {
+      std::sort(finite.begin(), finite.end());
+      span = finite[finite.size() * 95 / 100] - finite[finite.size() * 5 / 100];
+    }
+  }
+  double height = options_.height > 0 ? options_.height : 1;
+  return height / (span > 0 && std::isfinite(span) ? span : 1);
+}
+
+// Distance in pixels from the midpoint value to the chord. Entering or
+// leaving the domain (NaN or infinity at some but not all three points)
+// always counts as infinitely far, so domain edges are located as finely as
+// the limits allow.
+double AdaptiveSampler::Deviation(double left, double middle, double right,
+                                  double scale) const {
+  int finite = std::isfinite(left) + std::isfinite(middle) +
+               std::isfinite(right);
+  if (finite == 0) {
+    return 0;
+  } else if (finite < 3) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return std::fabs(middle - (left + right) / 2) * scale;
+}
+
+};  // namespace s21
@@ -0,0 +1,85 @@
+#ifndef SMARTCALC_MODEL_SAMPLER_H_
+#define SMARTCALC_MODEL_SAMPLER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "interval.h"
+
+namespace s21 {
+
+struct SamplingOptions {
+  size_t initial_points = 257;
+  size_t max_points = 100000;
+  size_t max_depth = 16;
+  // Largest allowed distance, in pixels, between the curve at an interval's
+  // midpoint and the chord drawn across the interval.
+  double tolerance = 0.5;
+  double width = 800;
+  double height = 600;
+  // Intervals no wider than this many pixels are not split.
+  double min_spacing = 1.0 / 16;
+  // Pixels per unit of y for the chord and break tests; 0 takes it from the
+  // y range, or from the spread of the first samples without one.
+  double scale = 0;
+  bool detect_breaks = true;
+  // Checked before every batch: once it reads true, sampling stops and Sample
+  // returns what it has so far.
+  const std::atomic<bool> *cancel = nullptr;
+};
+
+// Options for a view of width by height logical pixels: sizes in device
+// pixels, and at most two samples per device pixel column, as many as a line
+// through a column's extremes needs, within max_points.
+SamplingOptions ViewportSampling(double width, double height,
+                                 double pixel_ratio, size_t max_points);
+
+// Curvature-driven sampling for plots: starts from a uniform grid, then
+// bisects every interval whose midpoint is off the chord by more than the
+// pixel tolerance, or where the curve leaves or enters its domain. Midpoints
+// of one level are evaluated in a single batch, until max_depth levels,
+// max_points evaluations or min_spacing pixels in width.
+//
+// With detect_breaks, neighbours that jump by more than an eighth of the view
+// height are then bisected towards the steeper half: a continuous curve's
+// jump shrinks with the interval, a pole or a step keeps it. Confirmed breaks
+// and domain exits get a NaN separator, which QCPGraph draws as a gap, and
+// infinities are turned into NaN. The probes use what refinement left of
+// max_points, and at least one probe per two pixel columns on top of it.
+//
+// An optional enclosure of the curve over [low, high] lets intervals that are
+// provably undefined, or outside [low_y, high_y] when that is set, stay
+// unrefined even though both their ends are hidden.
+class AdaptiveSampler {
+ public:
+  using Evaluator =
+      std::function<void(const double *xs, double *out, size_t count)>;
+  using Enclosure = std::function<Interval(double low, double high)>;
+
+  explicit AdaptiveSampler(const SamplingOptions &options = {});
+
+  std::pair<std::vector<double>, std::vector<double>> Sample(
+      const Evaluator &evaluate, double low_x, double high_x, double low_y,
+      double high_y, const Enclosure &enclose = nullptr);
+  size_t Evaluations() const noexcept;
+  // The scale Sample uses with these first samples.
+  double VerticalScale(const std::vector<double> &ys, double low_y,
+                       double high_y) const;
+
+ private:
+  void InsertBreaks(const Evaluator &evaluate, double scale,
+                    std::vector<double> &xs, std::vector<double> &ys);
+  double Deviation(double left, double middle, double right,
+                   double scale) const;
+  bool isCancelled() const noexcept;
+
+  SamplingOptions options_;
+  size_t evaluations_ = 0;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_SAMPLER_H_
@@ -0,0 +1,135 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace s21 {
+
+namespace {
+
+struct Batch {
+  std::atomic<size_t> remaining{0};
+  std::mutex mutex;
+  std::condition_variable done;
+  std::exception_ptr error;
+};
+
+};  // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+  if (!threads) {
+    threads = DefaultThreadCount();
+  }
+  for (size_t i = 1; i < threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    workers_.emplace_back(&ThreadPool::Work, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::ThreadCount() const noexcept { return workers_.size() + 1; }
+
+size_t ThreadPool::DefaultThreadCount() noexcept {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const Range &body) {
+  grain = std::max<size_t>(grain, 1);
+  if (workers_.empty() || count <= grain) {
+    if (count) body(0, count);
+    return;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->remaining = (count + grain - 1) / grain;
+  for (size_t begin = 0; begin < count; begin += grain) {
+    size_t end = std::min(count, begin + grain);
+    Push(next_queue_++ % queues_.size(), [batch, &body, begin, end]() {
+      try {
+        body(begin, end);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        if (!batch->error) batch->error = std::current_exception();
+      }
+      if (--batch->remaining == 0) {
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        batch->done.notify_all();
+      }
+    });
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  wake_.notify_all();
+
+  Task task;
+  while (batch->remaining && Take(queues_.size(), task)) {
+    task();
+  }
+  std::unique_lock<std::mutex> lock(batch->mutex);
+  batch->done.wait(lock, [&]() { return batch->remaining == 0; });
+  if (batch->error) {
+    std::rethrow_exception(batch->error);
+  }
+}
+
+void ThreadPool::Push(size_t queue, Task task) {
+  std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+  queues_[queue]->tasks.push_back(std::move(task));
+  ++queued_;
+}
+
+// Own deque from the back (most recently pushed, still warm in cache), the
+// others from the front. Callers outside the pool pass queues_.size().
+bool ThreadPool::Take(size_t queue, Task &task) {
+  if (queue < queues_.size()) {
+    std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+    if (!queues_[queue]->tasks.empty()) {
+      task = std::move(queues_[queue]->tasks.back());
+      queues_[queue]->tasks.pop_back();
+      --queued_;
+      return true;
+    }
+  }
+  for (size_t i = 1; i <= queues_.size(); ++i) {
+    size_t victim = (queue + i) % queues_.size();
+    std::lock_guard<std::mutex> lock(queues_[victim]->mutex);
+    if (!queues_[victim]->tasks.empty()) {
+      task = std::move(queues_[victim]->tasks.front());
+      queues_[victim]->tasks.pop_front();
+      --queued_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::Work(size_t queue) {
+  Task task;
+  while (true) {
+    if (Take(queue, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [&]() { return stop_ || queued_ > 0; });
+    if (stop_ && queued_ == 0) {
+      return;
+    }
+  }
+}
+
+};  // namespace s21
@@ -0,0 +1,57 @@
+#ifndef SMARTCALC_MODEL_THREAD_POOL_H_
+#define SMARTCALC_MODEL_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+
+// Fixed set of workers, each with its own task deque: a worker pops from the
+// back of its deque and steals from the front of the others when it runs dry.
+// ParallelFor splits [0, count) into grain-sized chunks and returns when all
+// of them ran; the calling thread works on chunks too, so nested calls from
+// inside a chunk cannot deadlock.
+class ThreadPool {
+ public:
+  using Range = std::function<void(size_t begin, size_t end)>;
+
+  explicit ThreadPool(size_t threads = 0);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  size_t ThreadCount() const noexcept;
+  void ParallelFor(size_t count, size_t grain, const Range &body);
+
+  static size_t DefaultThreadCount() noexcept;
+
+ private:
+  using Task = std::function<void()>;
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void Push(size_t queue, Task task);
+  bool Take(size_t queue, Task &task);
+  void Work(size_t queue);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<size_t> queued_{0};
+  std::atomic<size_t> next_queue_{0};
+  bool stop_ = false;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_THREAD_POOL_H_
@@ -0,0 +1,261 @@
+#include "tile_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace s21 {
+
+namespace {
+
+// Samples of tile within [low, high] that come after the last one so far;
+// neighbouring tiles share their common end.
+void Append(const TileCache::Tile &tile, double low, double high,
+            TileCache::Samples &samples) {
+  for (size_t k = 0; k < tile.x.size(); ++k) {
+    double x = tile.x[k];
+    if (x >= low && x <= high &&
+        (samples.first.empty() || x > samples.first.back())) {
+      samples.first.push_back(x);
+      samples.second.push_back(tile.y[k]);
+    }
+  }
+}
+
+// Drops samples beyond the nearest one outside either end of [low, high].
+void Trim(double low, double high, TileCache::Samples &samples) {
+  std::vector<double> &xs = samples.first, &ys = samples.second;
+  size_t end = std::lower_bound(xs.begin(), xs.end(), high) - xs.begin();
+  end = std::min(end + 1, xs.size());
+  xs.resize(end);
+  ys.resize(end);
+  size_t begin = std::upper_bound(xs.begin(), xs.end(), low) - xs.begin();
+  begin = begin > 0 ? begin - 1 : 0;
+  xs.erase(xs.begin(), xs.begin() + begin);
+  ys.erase(ys.begin(), ys.begin() + begin);
+}
+
+bool SameSampling(const SamplingOptions &a, const SamplingOptions &b) {
+  return a.initial_points == b.initial_points &&
+         a.max_points == b.max_points && a.max_depth == b.max_depth &&
+         a.tolerance == b.tolerance && a.width == b.width &&
+         a.height == b.height && a.min_spacing == b.min_spacing &&
+         a.scale == b.scale && a.detect_breaks == b.detect_breaks;
+}
+
+};  // namespace
+
+double TileCache::Statistics::HitRatio() const {
+  return hits + misses ? double(hits) / (hits + misses) : 0;
+}
+
+TileCache::TileCache(size_t budget, double tile_pixels)
+    : budget_(budget), tile_pixels_(tile_pixels > 0 ? tile_pixels : 1) {}
+
+int TileCache::Level(double units_per_pixel) const {
+  double level = std::round(std::log2(units_per_pixel * tile_pixels_));
+  return std::isfinite(level) ? int(std::clamp(level, -1000.0, 1000.0)) : 0;
+}
+
+double TileCache::TilePixels() const noexcept { return tile_pixels_; }
+
+bool TileCache::Assemble(const std::string &expression,
+                         const SamplingOptions &options, double low_x,
+                         double high_x, int level, const Sampler &sample,
+                         Samples &samples, std::vector<int64_t> *missing) {
+  return Collect(expression, options, low_x, high_x, level, sample, samples,
+                 missing, true);
+}
+
+bool TileCache::Refill(const std::string &expression,
+                       const SamplingOptions &options, double low_x,
+                       double high_x, int level, const Sampler &sample,
+                       Samples &samples) {
+  return Collect(expression, options, low_x, high_x, level, sample, samples,
+                 nullptr, false);
+}
+
+bool TileCache::Collect(const std::string &expression,
+                        const SamplingOptions &options, double low_x,
+                        double high_x, int level, const Sampler &sample,
+                        Samples &samples, std::vector<int64_t> *missing,
+                        bool count) {
+  double width = std::ldexp(1.0, level);
+  double first = std::floor(low_x / width);
+  double last = std::ceil(high_x / width) - 1;
+  if (!(high_x > low_x) || !std::isfinite(first) || !std::isfinite(last) ||
+      std::fabs(first) > 1e15 || last - first + 1 > kMaxTiles) {
+    return false;
+  }
+  SamplingOptions sampling = options;
+  sampling.cancel = nullptr;
+  samples.first.clear();
+  samples.second.clear();
+  for (int64_t i = first; i <= last; ++i) {
+    double low = i * width, high = (i + 1) * width;
+    Key key{expression, sampling, level, i};
+    Entry tile = Find(key, count);
+    if (!tile && missing) {
+      missing->push_back(i);
+      tile = StandIn(key, low, high);
+      if (!tile) {
+        samples.first.push_back(low + width / 2);
+        samples.second.push_back(NAN);
+        continue;
+      }
+    } else if (!tile) {
+      Tile sampled;
+      if (!sample(low, high, options, sampled)) {
+        break;
+      }
+      tile = Put(std::move(key), std::move(sampled));
+    }
+    Append(*tile, low, high, samples);
+  }
+  Trim(low_x, high_x, samples);
+  return true;
+}
+
+double TileCache::Scale(const std::string &expression,
+                        const SamplingOptions &options, int level,
+                        const std::function<double()> &compute) {
+  SamplingOptions sampling = options;
+  sampling.cancel = nullptr;
+  sampling.scale = 0;
+  Key key{expression, sampling, level, 0};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = scales_.find(key);
+    if (found != scales_.end()) {
+      return found->second;
+    }
+  }
+  double scale = compute();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (scales_.size() >= kMaxScales) {
+    scales_.clear();
+  }
+  return scales_.emplace(std::move(key), scale).first->second;
+}
+
+void TileCache::SetBudget(size_t budget) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  budget_ = budget;
+  Evict();
+}
+
+size_t TileCache::Budget() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return budget_;
+}
+
+size_t TileCache::Bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+size_t TileCache::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+TileCache::Statistics TileCache::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void TileCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  index_.clear();
+  entries_.clear();
+  scales_.clear();
+  bytes_ = 0;
+}
+
+bool TileCache::Key::operator==(const Key &other) const noexcept {
+  return level == other.level && index == other.index &&
+         expression == other.expression && SameSampling(options, other.options);
+}
+
+size_t TileCache::KeyHash::operator()(const Key &key) const noexcept {
+  size_t hash = std::hash<std::string>{}(key.expression);
+  hash = hash * 31 + std::hash<size_t>{}(key.options.max_points);
+  hash = hash * 31 + std::hash<double>{}(key.options.scale);
+  hash = hash * 31 + std::hash<int>{}(key.level);
+  return hash * 31 + std::hash<int64_t>{}(key.index);
+}
+
+TileCache::Entry TileCache::Find(const Key &key, bool count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    return nullptr;
+  }
+  stats_.hits += count;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->second;
+}
+
+// The covering tile of the nearest coarser level, or else both halves from
+// the level below, cut to [low, high].
+TileCache::Entry TileCache::StandIn(const Key &key, double low,
+                                    double high) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Entry> parts;
+  for (int up = 1; up <= kStandInLevels && parts.empty(); ++up) {
+    auto found = index_.find(
+        Key{key.expression, key.options, key.level + up, key.index >> up});
+    if (found != index_.end()) {
+      parts.push_back(found->second->second);
+    }
+  }
+  bool halves = parts.empty();
+  for (int64_t half = 0; halves && half < 2; ++half) {
+    auto found = index_.find(
+        Key{key.expression, key.options, key.level - 1, key.index * 2 + half});
+    if (found == index_.end()) {
+      return nullptr;
+    }
+    parts.push_back(found->second->second);
+  }
+  ++stats_.stand_ins;
+  Samples samples;
+  for (const Entry &part : parts) {
+    Append(*part, low, high, samples);
+  }
+  return std::make_shared<const Tile>(
+      Tile{std::move(samples.first), std::move(samples.second)});
+}
+
+TileCache::Entry TileCache::Put(Key key, Tile tile) {
+  size_t bytes = Bytes(key, tile);
+  Entry entry = std::make_shared<const Tile>(std::move(tile));
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.misses;
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    return found->second->second;
+  } else if (bytes <= budget_) {
+    entries_.emplace_front(key, entry);
+    index_.emplace(std::move(key), entries_.begin());
+    bytes_ += bytes;
+    Evict();
+  }
+  return entry;
+}
+
+size_t TileCache::Bytes(const Key &key, const Tile &tile) {
+  return sizeof(Key) + sizeof(Tile) + key.expression.size() +
+         (tile.x.capacity() + tile.y.capacity()) * sizeof(double);
+}
+
+// Caller holds mutex_.
+void TileCache::Evict() {
+  while (bytes_ > budget_ && !entries_.empty()) {
+    bytes_ -= Bytes(entries_.back().first, *entries_.back().second);
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+    ++stats_.evictions;
+  }
+}
+
+};  // namespace s21
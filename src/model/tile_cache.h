@@ -0,0 +1,134 @@
+#ifndef SMARTCALC_MODEL_TILE_CACHE_H_
+#define SMARTCALC_MODEL_TILE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sampler.h"
+
+namespace s21 {
+
+// Sampled pieces of curves, so that panning and zooming only sample what
+// was not in view before. A tile of level L is 2^L units wide and tile i
+// covers [i * 2^L, (i + 1) * 2^L]: a pan keeps the tiles that stay in view,
+// and a zoom by two moves one level. Tiles are kept by expression, sampling
+// options, level and index, the least recently used evicted once their
+// samples take more than the memory budget, so a tile is only reused for
+// views that would have sampled it the same way. All members are
+// thread-safe.
+class TileCache {
+ public:
+  struct Tile {
+    std::vector<double> x;
+    std::vector<double> y;
+  };
+  using Entry = std::shared_ptr<const Tile>;
+  using Samples = std::pair<std::vector<double>, std::vector<double>>;
+  // Samples [low, high], both ends included, into tile as options say;
+  // false when it was interrupted, and the tile is then not kept.
+  using Sampler = std::function<bool(
+      double low, double high, const SamplingOptions &options, Tile &tile)>;
+  // Tiles that were cached, tiles shown from another level until they were
+  // sampled, tiles sampled, and tiles evicted.
+  struct Statistics {
+    size_t hits = 0;
+    size_t stand_ins = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    // Share of the tiles needed that did not have to be sampled.
+    double HitRatio() const;
+  };
+
+  static constexpr size_t kBudget = 16 << 20;
+  static constexpr double kTilePixels = 256;
+  // Views needing more tiles than this are not tiled.
+  static constexpr size_t kMaxTiles = 64;
+  // Levels above a missing tile searched for a stand-in.
+  static constexpr int kStandInLevels = 4;
+  // Scales kept before they are all dropped.
+  static constexpr size_t kMaxScales = 1024;
+
+  explicit TileCache(size_t budget = kBudget,
+                     double tile_pixels = kTilePixels);
+  TileCache(const TileCache &) = delete;
+  TileCache &operator=(const TileCache &) = delete;
+
+  // The level whose tiles are nearest to tile_pixels pixels wide.
+  int Level(double units_per_pixel) const;
+  double TilePixels() const noexcept;
+
+  // Samples of expression over [low_x, high_x] at level, ascending, and the
+  // nearest outside either end when there is one: tiles cached for the same
+  // options, and sample with them for the rest, stopping at the first one it
+  // interrupts. With missing,
+  // tiles that are not cached are instead shown from the nearest cached
+  // level, or left as a gap, and their indices appended to it. False, and
+  // samples untouched, when the range needs more than kMaxTiles tiles.
+  bool Assemble(const std::string &expression, const SamplingOptions &options,
+                double low_x, double high_x, int level, const Sampler &sample,
+                Samples &samples, std::vector<int64_t> *missing = nullptr);
+  // Assemble again after Assemble with missing, sampling what it listed; the
+  // tiles that were cached then are not counted as hits twice.
+  bool Refill(const std::string &expression, const SamplingOptions &options,
+              double low_x, double high_x, int level, const Sampler &sample,
+              Samples &samples);
+
+  // The vertical scale, in pixels per unit, that the tiles of expression at
+  // level were sampled with for options other than their scale. compute
+  // gives it the first time; after that it stays for the level, so that
+  // pans do not change the tiles' options whatever the spread in view.
+  double Scale(const std::string &expression, const SamplingOptions &options,
+               int level, const std::function<double()> &compute);
+
+  void SetBudget(size_t budget);
+  size_t Budget() const;
+  size_t Bytes() const;
+  size_t Size() const;
+  Statistics Stats() const;
+  void Clear();
+
+ private:
+  struct Key {
+    std::string expression;
+    // Without cancel, which does not change what is sampled.
+    SamplingOptions options;
+    int level;
+    int64_t index;
+    bool operator==(const Key &other) const noexcept;
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const noexcept;
+  };
+  using List = std::list<std::pair<Key, Entry>>;
+
+  bool Collect(const std::string &expression, const SamplingOptions &options,
+               double low_x, double high_x, int level, const Sampler &sample,
+               Samples &samples, std::vector<int64_t> *missing, bool count);
+  Entry Find(const Key &key, bool count);
+  Entry StandIn(const Key &key, double low, double high);
+  Entry Put(Key key, Tile tile);
+  static size_t Bytes(const Key &key, const Tile &tile);
+  void Evict();
+
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  List entries_;
+  std::unordered_map<Key, List::iterator, KeyHash> index_;
+  std::unordered_map<Key, double, KeyHash> scales_;
+  size_t budget_;
+  size_t bytes_ = 0;
+  double tile_pixels_;
+  Statistics stats_;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_TILE_CACHE_H_
@@ -0,0 +1,91 @@
+#ifndef SMARTCALC_MODEL_TRIE_H_
+#define SMARTCALC_MODEL_TRIE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace s21 {
+
+// Prefix tree over a fixed word list, built by the constexpr constructor so
+// that a static constexpr instance costs nothing at run time. Characters are
+// mapped to a dense alphabet of those used by the words; Match walks one
+// table row per input character and returns the longest word that prefixes
+// the input, so lookup time does not depend on the number of words.
+template <typename Value, size_t kNodes, size_t kAlphabet = 32>
+class StaticTrie {
+  static_assert(kNodes <= 256 && kAlphabet < 256, "node indices are bytes");
+
+ public:
+  using Word = std::pair<std::string_view, Value>;
+
+  template <size_t N>
+  constexpr explicit StaticTrie(const std::array<Word, N> &words) {
+    for (const Word &word : words) {
+      size_t node = 0;
+      for (char c : word.first) {
+        size_t symbol = Symbol(c);
+        if (!next_[node][symbol]) {
+          if (++size_ == kNodes) {
+            throw std::length_error("StaticTrie: too many nodes");
+          }
+          next_[node][symbol] = size_;
+        }
+        node = next_[node][symbol];
+      }
+      terminal_[node] = true;
+      value_[node] = word.second;
+    }
+  }
+
+  // Length of the longest word at the start of input, 0 if there is none;
+  // value receives its value.
+  constexpr size_t Match(std::string_view input, Value &value) const noexcept {
+    size_t length = 0;
+    for (size_t i = 0, node = 0; i < input.size(); ++i) {
+      unsigned char c = input[i];
+      if (c >= symbols_.size() || !symbols_[c]) {
+        break;
+      }
+      node = next_[node][symbols_[c] - 1];
+      if (!node) {
+        break;
+      } else if (terminal_[node]) {
+        value = value_[node];
+        length = i + 1;
+      }
+    }
+    return length;
+  }
+
+  constexpr size_t NodeCount() const noexcept { return size_ + 1; }
+
+ private:
+  constexpr size_t Symbol(char c) {
+    unsigned char u = c;
+    if (u >= symbols_.size()) {
+      throw std::invalid_argument("StaticTrie: not an ASCII word");
+    } else if (!symbols_[u]) {
+      if (alphabet_ == kAlphabet) {
+        throw std::length_error("StaticTrie: alphabet too large");
+      }
+      symbols_[u] = ++alphabet_;
+    }
+    return symbols_[u] - 1;
+  }
+
+  // 1 + index in the alphabet, 0 for characters no word contains.
+  std::array<uint8_t, 128> symbols_{};
+  std::array<std::array<uint8_t, kAlphabet>, kNodes> next_{};
+  std::array<Value, kNodes> value_{};
+  std::array<bool, kNodes> terminal_{};
+  size_t size_ = 0;
+  size_t alphabet_ = 0;
+};
+
+};  // namespace s21
+
+#endif  // SMARTCALC_MODEL_TRIE_H_
@@ -3,9 +3,27 @@ greaterThan(QT_MAJOR_VERSION, 4): QT+=widgets printsupport
 
 CONFIG+=c++17 object_parallel_to_source
 RESOURCES+=view/icons/icons.qrc
+unix: LIBS+=-ldl
 
 SOURCES+=\
 	model/calculator.cc\
+	model/lexeme.cc\
+	model/expression.cc\
+	model/program.cc\
+	model/dag.cc\
+	model/jit.cc\
+	model/native.cc\
+	model/thread_pool.cc\
+	model/sampler.cc\
+	model/interval.cc\
+	model/dual.cc\
+	model/roots.cc\
+	model/integrator.cc\
+	model/expression_cache.cc\
+	model/plot_worker.cc\
+	model/tile_cache.cc\
+	model/kernels.cc\
+	model/dispatch.cc\
 	model/credit.cc\
 	controller/controller.cc\
 	view/graph.cc\
@@ -16,6 +34,25 @@ SOURCES+=\
 
 HEADERS+=\
 	model/calculator.h\
+	model/lexeme.h\
+	model/expression.h\
+	model/program.h\
+	model/dag.h\
+	model/jit.h\
+	model/native.h\
+	model/thread_pool.h\
+	model/sampler.h\
+	model/interval.h\
+	model/dual.h\
+	model/roots.h\
+	model/integrator.h\
+	model/trie.h\
+	model/expression_cache.h\
+	model/plot_worker.h\
+	model/tile_cache.h\
+	model/kernels.h\
+	model/kernels.inc\
+	model/dispatch.h\
 	model/credit.h\
 	controller/controller.h\
 	view/graph.h\
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <thread>
+#include <vector>
 
 #include "../model/calculator.h"
 
@@ -165,6 +167,231 @@ TEST_F(CalcTest, CalculatePlot) {
   EXPECT_EQ(xy.second[3], 1);
 }
 
+TEST_F(CalcTest, programMatchesReference) {
+  const std::vector<std::string> expressions{
+      "x",
+      "-x+5",
+      "+x*2",
+      "3 + 4 * 2 / ( 1 - 5 ) ^ 2 ^ 3 + x",
+      "sin(x)^2+cos(x)^2",
+      "tan(x) - ctg(x) + atan(x)",
+      "asin(x / 100) * acos(x / 100)",
+      "sqrt(x) + ln(x) + log(x)",
+      "x mod 3 + x % -7",
+      "2 ^ x ^ 0.5",
+      "-(x--x)*sincossincosx",
+  };
+  for (const std::string &expression : expressions) {
+    for (double x = -10; x <= 10; x += 0.37) {
+      double expected = m.CalculateReference(expression, x);
+      double actual = m.Calculate(expression, x);
+      if (std::isnan(expected)) {
+        EXPECT_TRUE(std::isnan(actual)) << expression << " at " << x;
+      } else {
+        EXPECT_EQ(actual, expected) << expression << " at " << x;
+      }
+    }
+  }
+}
+
+TEST_F(CalcTest, programDeepNesting) {
+  std::string input = "x";
+  for (int i = 0; i < 100; ++i) {
+    input = "1+(" + input + ")";
+  }
+  EXPECT_EQ(m.Calculate(input, 1), 101);
+  EXPECT_EQ(m.CalculateReference(input, 1), 101);
+}
+
+TEST_F(CalcTest, programErrorsAfterFailedCompile) {
+  EXPECT_EQ(m.Calculate("x+1", 1), 2);
+  EXPECT_THROW(m.Calculate("x+"), std::logic_error);
+  EXPECT_EQ(m.Calculate("x+1", 2), 3);
+}
+
+TEST_F(CalcTest, evaluateBatchMatchesScalar) {
+  const std::vector<std::string> expressions{
+      "x", "5", "-x*x+3/x", "sin(x)^2+cos(x)^2", "x mod 2 + sqrt(x) - ln(x)",
+      "atan(tan(x))*log(x^2)"};
+  std::vector<double> xs(1000);
+  for (size_t i = 0; i < xs.size(); ++i) {
+    xs[i] = -50 + 0.1 * i;
+  }
+  std::vector<double> out(xs.size());
+  for (const std::string &expression : expressions) {
+    m.EvaluateBatch(expression, xs.data(), out.data(), xs.size());
+    for (size_t i = 0; i < xs.size(); ++i) {
+      double expected = m.Calculate(expression, xs[i]);
+      if (std::isnan(expected)) {
+        EXPECT_TRUE(std::isnan(out[i])) << expression << " at " << xs[i];
+      } else if (std::isinf(expected)) {
+        EXPECT_EQ(out[i], expected) << expression << " at " << xs[i];
+      } else {
+        EXPECT_NEAR(out[i], expected, 1e-12 * std::max(1.0, fabs(expected)))
+            << expression << " at " << xs[i];
+      }
+    }
+  }
+}
+
+TEST_F(CalcTest, evaluateBatchEmpty) {
+  std::vector<double> xs{1, 2, 3}, out(3, 1);
+  m.EvaluateBatch("()", xs.data(), out.data(), xs.size());
+  EXPECT_EQ(out, std::vector<double>(3, 0));
+  m.EvaluateBatch("x", xs.data(), out.data(), 0);
+  EXPECT_EQ(out, std::vector<double>(3, 0));
+}
+
+TEST_F(CalcTest, foldConstants) {
+  s21::Program program;
+  program.PushConstant(2);
+  program.PushConstant(3.14159);
+  program.Apply(s21::Instruction::MUL);
+  program.PushConstant(360);
+  program.Apply(s21::Instruction::DIV);
+  program.PushX();
+  program.Apply(s21::Instruction::MUL);
+  program.PushConstant(2);
+  program.Apply(s21::Instruction::SQRT);
+  program.Apply(s21::Instruction::ADD);
+
+  s21::Program folded = program.FoldConstants();
+  EXPECT_EQ(folded.Code().size(), 5u);
+  EXPECT_EQ(folded.Constants().size(), 2u);
+  EXPECT_EQ(folded.Constants()[0], 2 * 3.14159 / 360);
+  EXPECT_EQ(folded.Constants()[1], sqrt(2));
+  for (double x = -3; x <= 3; x += 0.5) {
+    EXPECT_EQ(folded.Evaluate(x), program.Evaluate(x));
+  }
+}
+
+TEST_F(CalcTest, foldConstantsBelowX) {
+  s21::Program program;
+  program.PushConstant(1);
+  program.PushConstant(2);
+  program.Apply(s21::Instruction::ADD);
+  program.PushX();
+  program.PushConstant(4);
+  program.Apply(s21::Instruction::NEG);
+  program.Apply(s21::Instruction::POW);
+  program.Apply(s21::Instruction::SUB);
+
+  s21::Program folded = program.FoldConstants();
+  EXPECT_EQ(folded.Code().size(), 5u);
+  EXPECT_EQ(folded.Constants(), std::vector<double>({3, -4}));
+  EXPECT_EQ(folded.Evaluate(2), 3 - pow(2, -4));
+}
+
+TEST_F(CalcTest, foldConstantsWithoutX) {
+  s21::Program program;
+  program.PushConstant(2);
+  program.Apply(s21::Instruction::SQRT);
+  program.PushConstant(2);
+  program.Apply(s21::Instruction::DIV);
+  s21::Program folded = program.FoldConstants();
+  EXPECT_TRUE(folded.isConstant());
+  EXPECT_EQ(folded.Evaluate(7), sqrt(2) / 2);
+
+  std::pair<std::vector<double>, std::vector<double>> xy =
+      m.Calculate("sqrt(2)/2*sin(0)+1", -1, 1, 0, 0, 4000);
+  EXPECT_EQ(xy.second, std::vector<double>(4000, 1));
+}
+
+TEST_F(CalcTest, eliminateCommonSubexpressions) {
+  using s21::Instruction;
+  s21::Program program;
+  auto push_trig = [&](Instruction::OpCode op) {
+    program.PushX();
+    program.Apply(op);
+  };
+  push_trig(Instruction::SIN);
+  program.PushConstant(2);
+  program.Apply(Instruction::POW);
+  push_trig(Instruction::SIN);
+  push_trig(Instruction::COS);
+  program.Apply(Instruction::MUL);
+  program.Apply(Instruction::ADD);
+  push_trig(Instruction::COS);
+  program.PushConstant(2);
+  program.Apply(Instruction::POW);
+  program.Apply(Instruction::ADD);
+
+  s21::Program shared = program.EliminateCommonSubexpressions();
+  std::vector<int> counts(Instruction::OPCODE_END);
+  for (const Instruction &ins : shared.Code()) ++counts[ins.op];
+  EXPECT_EQ(counts[Instruction::LOAD_X], 1);
+  EXPECT_EQ(counts[Instruction::SIN], 1);
+  EXPECT_EQ(counts[Instruction::COS], 1);
+  EXPECT_EQ(counts[Instruction::LOAD_CONST], 1);
+  EXPECT_EQ(shared.Constants().size(), 1u);
+  EXPECT_LE(shared.SlotCount(), 4u);
+  for (double x = -10; x < 10; x += 0.37) {
+    EXPECT_EQ(shared.Evaluate(x), program.Evaluate(x));
+  }
+  std::vector<double> xs{-1, 0, 0.5, 3}, out(xs.size());
+  shared.EvaluateBatch(xs.data(), out.data(), xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) {
+    EXPECT_NEAR(out[i], 1 + sin(xs[i]) * cos(xs[i]), 1e-12);
+  }
+}
+
+TEST_F(CalcTest, eliminateCommonSubexpressionsKeepsOrder) {
+  EXPECT_EQ(m.Calculate("(x-1)/(1-x)+(x-1)", 3), 1);
+  EXPECT_EQ(m.Calculate("x mod 2 + 2 mod x", 3), 3);
+  EXPECT_EQ(m.Calculate("x^2+2^x", 3), 17);
+  EXPECT_EQ(m.Calculate("2*x+x*2", 3), 12);
+  EXPECT_EQ(m.Calculate("x", 3), 3);
+  EXPECT_EQ(m.Calculate("5", 3), 5);
+  s21::Program empty;
+  EXPECT_TRUE(empty.EliminateCommonSubexpressions().isEmpty());
+}
+
+TEST(CompiledExpressionTest, compileAndEvaluate) {
+  s21::CompiledExpression expression = s21::Compile("x^2 - 3*x + sin(x)");
+  EXPECT_TRUE(expression.isContainingX());
+  EXPECT_FALSE(expression.isEmpty());
+  EXPECT_EQ(expression.Evaluate(2), 4 - 6 + sin(2));
+  EXPECT_EQ(expression.Evaluate(2), expression.EvaluateReference(2));
+  EXPECT_FALSE(s21::Compile("2+2").isContainingX());
+  EXPECT_TRUE(s21::Compile("").isEmpty());
+  EXPECT_EQ(s21::Compile("").Evaluate(1), 0);
+  EXPECT_THROW(s21::Compile("x+"), std::invalid_argument);
+  EXPECT_THROW(s21::Compile("(x"), std::invalid_argument);
+}
+
+TEST(CompiledExpressionTest, sharedAcrossThreads) {
+  const s21::CompiledExpression expression =
+      s21::Compile("sqrt(x*x+1)/(1+cos(x)^2) - x mod 3");
+  std::vector<double> xs(20000);
+  for (size_t i = 0; i < xs.size(); ++i) xs[i] = i * 0.01 - 100;
+  std::vector<double> expected(xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) {
+    expected[i] = expression.Evaluate(xs[i]);
+  }
+
+  constexpr size_t kThreads = 4;
+  std::vector<std::vector<double>> scalar(kThreads), batch(kThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      s21::CompiledExpression copy = expression;
+      scalar[t].resize(xs.size());
+      batch[t].resize(xs.size());
+      for (size_t i = 0; i < xs.size(); ++i) {
+        scalar[t][i] = (t % 2 ? copy : expression).Evaluate(xs[i]);
+      }
+      expression.EvaluateBatch(xs.data(), batch[t].data(), xs.size());
+    });
+  }
+  for (std::thread &thread : threads) thread.join();
+  for (size_t t = 0; t < kThreads; ++t) {
+    EXPECT_EQ(scalar[t], expected);
+    for (size_t i = 0; i < xs.size(); ++i) {
+      EXPECT_NEAR(batch[t][i], expected[i], 1e-12 * (1 + fabs(expected[i])));
+    }
+  }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/dual.h"
+
+namespace {
+
+struct Derivatives {
+  std::vector<double> values, first, second;
+};
+
+Derivatives Differentiate(s21::CalculatorModel &model,
+                          const std::string &input,
+                          const std::vector<double> &xs) {
+  Derivatives d{std::vector<double>(xs.size()), std::vector<double>(xs.size()),
+                std::vector<double>(xs.size())};
+  model.EvaluateDerivatives(input, xs.data(), d.values.data(), d.first.data(),
+                            d.second.data(), xs.size());
+  return d;
+}
+
+TEST(DualTest, everyOperator) {
+  struct Case {
+    const char *input;
+    std::function<double(double)> f1, f2;
+  };
+  const std::vector<Case> cases{
+      {"-x", [](double) { return -1.0; }, [](double) { return 0.0; }},
+      {"+x", [](double) { return 1.0; }, [](double) { return 0.0; }},
+      {"cos(x)", [](double x) { return -std::sin(x); },
+       [](double x) { return -std::cos(x); }},
+      {"sin(x)", [](double x) { return std::cos(x); },
+       [](double x) { return -std::sin(x); }},
+      {"tan(x)", [](double x) { return 1 / std::pow(std::cos(x), 2); },
+       [](double x) { return 2 * std::tan(x) / std::pow(std::cos(x), 2); }},
+      {"ctg(x)", [](double x) { return -1 / std::pow(std::sin(x), 2); },
+       [](double x) { return 2 * std::cos(x) / std::pow(std::sin(x), 3); }},
+      {"acos(x)", [](double x) { return -1 / std::sqrt(1 - x * x); },
+       [](double x) { return -x / std::pow(1 - x * x, 1.5); }},
+      {"asin(x)", [](double x) { return 1 / std::sqrt(1 - x * x); },
+       [](double x) { return x / std::pow(1 - x * x, 1.5); }},
+      {"atan(x)", [](double x) { return 1 / (1 + x * x); },
+       [](double x) { return -2 * x / std::pow(1 + x * x, 2); }},
+      {"sqrt(x)", [](double x) { return 0.5 / std::sqrt(x); },
+       [](double x) { return -0.25 / std::pow(x, 1.5); }},
+      {"ln(x)", [](double x) { return 1 / x; },
+       [](double x) { return -1 / (x * x); }},
+      {"log(x)", [](double x) { return 1 / (x * std::log(10)); },
+       [](double x) { return -1 / (x * x * std::log(10)); }},
+      {"x+x*x", [](double x) { return 1 + 2 * x; },
+       [](double) { return 2.0; }},
+      {"x-1/x", [](double x) { return 1 + 1 / (x * x); },
+       [](double x) { return -2 / (x * x * x); }},
+      {"x^3", [](double x) { return 3 * x * x; },
+       [](double x) { return 6 * x; }},
+      {"2^x", [](double x) { return std::pow(2, x) * std::log(2); },
+       [](double x) { return std::pow(2, x) * std::pow(std::log(2), 2); }},
+      {"x^x",
+       [](double x) { return std::pow(x, x) * (std::log(x) + 1); },
+       [](double x) {
+         return std::pow(x, x) * (std::pow(std::log(x) + 1, 2) + 1 / x);
+       }},
+      {"(x*x) mod 0.3", [](double x) { return 2 * x; },
+       [](double) { return 2.0; }},
+      {"1 mod x", [](double x) { return -std::trunc(1 / x); },
+       [](double) { return 0.0; }},
+  };
+  s21::CalculatorModel model;
+  std::vector<double> xs{0.15, 0.4, 0.55, 0.7, 0.95};
+  for (const Case &c : cases) {
+    Derivatives d = Differentiate(model, c.input, xs);
+    for (size_t i = 0; i < xs.size(); ++i) {
+      double x = xs[i];
+      EXPECT_DOUBLE_EQ(d.values[i], model.Calculate(c.input, x)) << c.input;
+      EXPECT_NEAR(d.first[i], c.f1(x), 1e-12 * (1 + std::fabs(c.f1(x))))
+          << c.input << " at " << x;
+      EXPECT_NEAR(d.second[i], c.f2(x), 1e-11 * (1 + std::fabs(c.f2(x))))
+          << c.input << " at " << x;
+    }
+  }
+}
+
+TEST(DualTest, matchesFiniteDifferences) {
+  s21::CalculatorModel model;
+  std::vector<double> xs;
+  for (double x = 0.3; x < 2.9; x += 0.137) xs.push_back(x);
+  for (const char *input :
+       {"sin(x)^2*cos(3*x)", "ln(1+x^2)/sqrt(x)", "(x^3-1)/(x^2+1)",
+        "atan(x)*x^x", "tan(x/3)-ctg(x+0.1)", "asin(x/3)+acos(x/4)",
+        "log(x)*2^sin(x)", "-(x*x) mod 1.7"}) {
+    Derivatives d = Differentiate(model, input, xs);
+    for (size_t i = 0; i < xs.size(); ++i) {
+      double x = xs[i], h = 1e-4;
+      double plus = model.Calculate(input, x + h);
+      double minus = model.Calculate(input, x - h);
+      double center = model.Calculate(input, x);
+      double f1 = (plus - minus) / (2 * h);
+      double f2 = (plus - 2 * center + minus) / (h * h);
+      if (std::fabs(f2) > 1e4) continue;  // a jump of mod
+      EXPECT_NEAR(d.first[i], f1, 1e-6 * (1 + std::fabs(f1)))
+          << input << " at " << x;
+      EXPECT_NEAR(d.second[i], f2, 1e-3 * (1 + std::fabs(f2)))
+          << input << " at " << x;
+    }
+  }
+}
+
+TEST(DualTest, optionalOutputsAndThreads) {
+  s21::CalculatorModel serial, parallel;
+  parallel.EnableParallelSampling(true, 4, 1000);
+  std::vector<double> xs(20000);
+  for (size_t i = 0; i < xs.size(); ++i) xs[i] = -10 + i * 1e-3;
+  const std::string input = "sin(x)*x^2/(1+x^2)";
+  Derivatives expected = Differentiate(serial, input, xs);
+  Derivatives actual = Differentiate(parallel, input, xs);
+  EXPECT_EQ(actual.values, expected.values);
+  EXPECT_EQ(actual.first, expected.first);
+  EXPECT_EQ(actual.second, expected.second);
+
+  std::vector<double> values(xs.size()), first(xs.size());
+  parallel.EvaluateDerivatives(input, xs.data(), values.data(), first.data(),
+                               nullptr, xs.size());
+  EXPECT_EQ(first, expected.first);
+  serial.EvaluateDerivatives(input, xs.data(), values.data(), nullptr,
+                             nullptr, xs.size());
+  EXPECT_EQ(values, expected.values);
+
+  serial.EvaluateDerivatives("4", xs.data(), values.data(), first.data(),
+                             nullptr, xs.size());
+  EXPECT_EQ(values, std::vector<double>(xs.size(), 4.0));
+  EXPECT_EQ(first, std::vector<double>(xs.size(), 0.0));
+}
+
+TEST(DualTest, chainRule) {
+  s21::Dual x = s21::Dual::Variable(2);
+  s21::Dual y = s21::ApplyDual(s21::Instruction::MUL, x, x);
+  s21::Dual z = s21::ApplyDual(s21::Instruction::SIN, y);
+  EXPECT_DOUBLE_EQ(z.value, std::sin(4));
+  EXPECT_DOUBLE_EQ(z.first, std::cos(4) * 4);
+  EXPECT_DOUBLE_EQ(z.second, -std::sin(4) * 16 + std::cos(4) * 2);
+}
+
+}  // namespace
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/expression_cache.h"
+
+namespace {
+
+using s21::ExpressionCache;
+
+ExpressionCache::Entry Get(ExpressionCache &cache, const std::string &input,
+                           int &compiled) {
+  return cache.Get(input, false, [&]() -> ExpressionCache::Entry {
+    ++compiled;
+    s21::CompiledExpression expression;
+    if (!s21::CalculatorModel().TryCompile(input, expression).isOk()) {
+      return nullptr;
+    }
+    return std::make_shared<const s21::CompiledExpression>(expression);
+  });
+}
+
+TEST(ExpressionCacheTest, evictsLeastRecentlyUsed) {
+  ExpressionCache cache(2);
+  int compiled = 0;
+  Get(cache, "x", compiled);
+  Get(cache, "2*x", compiled);
+  EXPECT_EQ(Get(cache, " x ", compiled)->Evaluate(3), 3);
+  Get(cache, "3*x", compiled);
+  EXPECT_EQ(compiled, 3);
+  EXPECT_EQ(cache.Size(), 2u);
+  ExpressionCache::Statistics stats = cache.Stats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 3u);
+  EXPECT_EQ(stats.evictions, 1u);
+
+  // 2*x went out, x was used more recently than it.
+  Get(cache, "x", compiled);
+  EXPECT_EQ(compiled, 3);
+  Get(cache, "2 * x", compiled);
+  EXPECT_EQ(compiled, 4);
+
+  EXPECT_EQ(Get(cache, "x +", compiled), nullptr);
+  EXPECT_EQ(Get(cache, "x +", compiled), nullptr);
+  EXPECT_EQ(compiled, 6);
+  EXPECT_EQ(cache.Size(), 2u);
+
+  cache.SetCapacity(1);
+  EXPECT_EQ(cache.Size(), 1u);
+  EXPECT_EQ(cache.Stats().evictions, 3u);
+  cache.SetCapacity(0);
+  Get(cache, "x", compiled);
+  EXPECT_EQ(cache.Size(), 0u);
+  cache.SetCapacity(4);
+  Get(cache, "x", compiled);
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0u);
+  EXPECT_EQ(cache.Capacity(), 4u);
+}
+
+TEST(ExpressionCacheTest, normalizesWhitespaceOnly) {
+  EXPECT_EQ(ExpressionCache::Normalize("  sin( x ) *\t2 "), "sin(x)*2");
+  EXPECT_EQ(ExpressionCache::Normalize("x mod  3"), "x mod 3");
+  EXPECT_EQ(ExpressionCache::Normalize("1 2"), "1 2");
+  EXPECT_EQ(ExpressionCache::Normalize("1e +5"), "1e +5");
+  EXPECT_EQ(ExpressionCache::Normalize("1e+ 5"), "1e+ 5");
+  EXPECT_EQ(ExpressionCache::Normalize("x - 5"), "x-5");
+
+  // Normalized text compiles to the same thing as the original.
+  const std::string alphabet = "0123456789.e+-*/^()   xsincotalgqrm";
+  std::mt19937 rng(11);
+  s21::CalculatorModel model;
+  for (int round = 0; round < 20000; ++round) {
+    std::string input;
+    for (size_t i = rng() % 16; i; --i) {
+      input += alphabet[rng() % alphabet.size()];
+    }
+    std::string normalized = ExpressionCache::Normalize(input);
+    s21::CompiledExpression a, b;
+    bool valid = model.TryCompile(input, a).isOk();
+    ASSERT_EQ(model.TryCompile(normalized, b).isOk(), valid) << input;
+    if (valid) {
+      double x = a.Evaluate(0.3), y = b.Evaluate(0.3);
+      ASSERT_TRUE(x == y || (std::isnan(x) && std::isnan(y))) << input;
+    }
+  }
+}
+
+TEST(ExpressionCacheTest, sharedBetweenModels) {
+  auto cache = std::make_shared<ExpressionCache>(8);
+  s21::CalculatorModel first, second;
+  first.ShareExpressionCache(cache);
+  second.ShareExpressionCache(cache);
+  EXPECT_EQ(first.Cache(), cache);
+
+  // Switching between two expressions compiles each once.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(first.Calculate("x^2", 3), 9);
+    EXPECT_EQ(first.Calculate("x + 1", 3), 4);
+  }
+  EXPECT_EQ(second.Calculate("x+1", 1), 2);
+  EXPECT_EQ(cache->Stats().misses, 2u);
+  EXPECT_EQ(cache->Stats().hits, 9u);
+
+  EXPECT_THROW(first.Calculate("x +", 0), std::invalid_argument);
+  EXPECT_EQ(first.Calculate("x^2", 2), 4);
+  EXPECT_EQ(cache->Size(), 2u);
+}
+
+TEST(ExpressionCacheTest, concurrentCallers) {
+  ExpressionCache cache(4);
+  const std::vector<std::string> inputs{"x", "x*2", "x*3", "x*4", "x*5",
+                                        "x*6"};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      int compiled = 0;
+      for (int i = 0; i < 2000; ++i) {
+        const std::string &input = inputs[(i * 7 + t) % inputs.size()];
+        ExpressionCache::Entry entry = Get(cache, input, compiled);
+        ASSERT_EQ(entry->Evaluate(1),
+                  s21::CalculatorModel().Calculate(input, 1));
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  ExpressionCache::Statistics stats = cache.Stats();
+  EXPECT_EQ(stats.hits + stats.misses, 8000u);
+  EXPECT_LE(cache.Size(), 4u);
+}
+
+}  // namespace
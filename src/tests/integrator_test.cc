@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/integrator.h"
+
+namespace {
+
+TEST(IntegratorTest, exactForPolynomials) {
+  s21::CalculatorModel model;
+  s21::Integral integral = model.Integrate("x^3 - 2*x + 1", 0, 2);
+  EXPECT_TRUE(integral.converged);
+  EXPECT_NEAR(integral.value, 4 - 4 + 2, 1e-14);
+  EXPECT_EQ(integral.evaluations, 15u);
+  EXPECT_EQ(model.LastEvaluationCount(), 15u);
+  EXPECT_EQ(integral.intervals, 1u);
+
+  integral = model.Integrate("x", 1, 0);
+  EXPECT_DOUBLE_EQ(integral.value, -0.5);
+  integral = model.Integrate("x", 3, 3);
+  EXPECT_EQ(integral.value, 0);
+  EXPECT_TRUE(integral.converged);
+}
+
+TEST(IntegratorTest, adaptsToDifficultIntegrands) {
+  s21::CalculatorModel model;
+  struct Case {
+    const char *input;
+    double low, high, expected;
+  };
+  for (const Case &c : std::vector<Case>{
+           {"sin(x)", 0, M_PI, 2},
+           {"sqrt(x)", 0, 1, 2.0 / 3},
+           {"1/sqrt(x)", 0, 1, 2},
+           {"ln(x)", 0, 1, -1},
+           {"1/(1+x^2)", -100, 100, 2 * std::atan(100)},
+           {"x mod 1", 0, 3.5, 1.5 + 0.125},
+           {"sin(1/x)", 0.05, 1, 0.5028396202159},
+       }) {
+    s21::Integral integral = model.Integrate(c.input, c.low, c.high);
+    EXPECT_TRUE(integral.converged) << c.input;
+    EXPECT_LE(integral.error,
+              std::max(1e-10, 1e-10 * std::fabs(integral.value)))
+        << c.input;
+    EXPECT_NEAR(integral.value, c.expected, 1e-9) << c.input;
+    EXPECT_EQ(integral.evaluations, model.LastEvaluationCount());
+  }
+}
+
+TEST(IntegratorTest, reportsDivergence) {
+  s21::CalculatorModel model;
+  s21::IntegrationOptions options;
+  options.max_intervals = 300;
+  s21::Integral integral = model.Integrate("1/x^2", 0, 1, options);
+  EXPECT_FALSE(integral.converged);
+  EXPECT_LE(integral.intervals, 300u);
+  EXPECT_GT(integral.error, 1);
+
+  integral = model.Integrate("sqrt(x)", -1, 1, options);
+  EXPECT_TRUE(std::isnan(integral.value));
+  EXPECT_FALSE(integral.converged);
+}
+
+TEST(IntegratorTest, toleranceControlsWork) {
+  s21::CalculatorModel model;
+  s21::IntegrationOptions loose, tight;
+  loose.absolute_tolerance = loose.relative_tolerance = 1e-4;
+  tight.absolute_tolerance = tight.relative_tolerance = 1e-13;
+  s21::Integral a = model.Integrate("1/sqrt(x)", 0, 1, loose);
+  s21::Integral b = model.Integrate("1/sqrt(x)", 0, 1, tight);
+  EXPECT_LT(a.evaluations, b.evaluations);
+  EXPECT_LT(std::fabs(b.value - 2), std::fabs(a.value - 2) + 1e-15);
+  EXPECT_NEAR(a.value, 2, 1e-4);
+}
+
+TEST(IntegratorTest, identicalForAnyThreadCount) {
+  s21::CalculatorModel serial;
+  for (size_t threads : {2, 3, 8}) {
+    s21::CalculatorModel parallel;
+    parallel.EnableParallelSampling(true, threads, 100);
+    for (const char *input : {"sin(1/x)*x", "ln(x)*x^2", "tan(x)"}) {
+      s21::Integral expected = serial.Integrate(input, 0.01, 3);
+      s21::Integral actual = parallel.Integrate(input, 0.01, 3);
+      EXPECT_EQ(actual.value, expected.value) << input;
+      EXPECT_EQ(actual.error, expected.error) << input;
+      EXPECT_EQ(actual.evaluations, expected.evaluations) << input;
+    }
+  }
+}
+
+}  // namespace
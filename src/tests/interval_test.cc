@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/interval.h"
+#include "../model/sampler.h"
+
+namespace {
+
+using s21::Interval;
+
+Interval Enclose(const std::string &input, double low_x, double high_x) {
+  return s21::Compile(input).Enclose(low_x, high_x);
+}
+
+TEST(IntervalTest, elementaryFunctions) {
+  Interval y = Enclose("sin(x)", 0, 4);
+  EXPECT_GE(y.high, 1);
+  EXPECT_NEAR(y.high, 1, 1e-12);
+  EXPECT_NEAR(y.low, std::sin(4), 1e-12);
+  EXPECT_FALSE(y.isPartial());
+  EXPECT_NEAR(Enclose("cos(x)", 3, 3.3).low, -1, 1e-12);
+  y = Enclose("cos(x)", 0.5, 1);
+  EXPECT_NEAR(y.low, std::cos(1), 1e-12);
+  EXPECT_NEAR(y.high, std::cos(0.5), 1e-12);
+  EXPECT_FALSE(Enclose("tan(x)", 1, 2).isBounded());
+  EXPECT_NEAR(Enclose("tan(x)", 0, 1).high, std::tan(1), 1e-12);
+  EXPECT_FALSE(Enclose("ctg(x)", -0.5, 0.5).isBounded());
+  EXPECT_TRUE(Enclose("ctg(x)", 0.5, 3).isBounded());
+
+  y = Enclose("sqrt(x)", -1, 4);
+  EXPECT_TRUE(y.isPartial());
+  EXPECT_NEAR(y.low, 0, 1e-300);
+  EXPECT_NEAR(y.high, 2, 1e-12);
+  EXPECT_TRUE(Enclose("ln(x)", -2, -1).isEmpty());
+  EXPECT_TRUE(Enclose("sqrt(-1-x^2)", -5, 5).isEmpty());
+  y = Enclose("asin(x)", 0.5, 2);
+  EXPECT_TRUE(y.isPartial());
+  EXPECT_NEAR(y.high, M_PI_2, 1e-12);
+  EXPECT_TRUE(Enclose("acos(x)", 2, 3).isEmpty());
+}
+
+TEST(IntervalTest, arithmetic) {
+  Interval y = Enclose("x^2", -2, 3);
+  EXPECT_NEAR(y.low, 0, 1e-12);
+  EXPECT_NEAR(y.high, 9, 1e-12);
+  EXPECT_FALSE(y.isPartial());
+  y = Enclose("x^3", -2, 1);
+  EXPECT_NEAR(y.low, -8, 1e-12);
+  EXPECT_NEAR(y.high, 1, 1e-12);
+  EXPECT_TRUE(Enclose("x^0.5", -2, -1).isEmpty());
+  EXPECT_TRUE(Enclose("x^0.5", -2, 1).isPartial());
+  EXPECT_FALSE(Enclose("1/x", -1, 1).isBounded());
+  y = Enclose("1/x", 1, 2);
+  EXPECT_NEAR(y.low, 0.5, 1e-12);
+  EXPECT_NEAR(y.high, 1, 1e-12);
+  y = Enclose("x mod 3", 4, 5);
+  EXPECT_NEAR(y.low, 1, 1e-12);
+  EXPECT_NEAR(y.high, 2, 1e-12);
+  y = Enclose("x mod 3", 2, 4);
+  EXPECT_LE(y.low, 0);
+  EXPECT_GE(y.high, 2.99);
+  y = Enclose("2+3", -1, 1);
+  EXPECT_TRUE(y.Contains(5));
+  EXPECT_LT(y.high - y.low, 1e-12);
+}
+
+// Every value computed by any backend over a random sub-range lies in the
+// enclosure of that sub-range, and NaN only appears where it is allowed.
+TEST(IntervalTest, enclosesComputedValues) {
+  std::mt19937_64 rng(11);
+  const std::vector<std::string> functions{
+      "sin", "cos", "tan", "ctg", "asin", "acos", "atan", "sqrt", "ln", "log",
+  };
+  const std::vector<std::string> operators{"+", "-", "*", "/", "^", " mod "};
+  std::function<std::string(int)> random = [&](int depth) -> std::string {
+    size_t choice = rng() % (depth > 0 ? 6 : 2);
+    if (choice == 0) {
+      return std::to_string(rng() % 1000 / 100.0);
+    } else if (choice == 1) {
+      return "x";
+    } else if (choice == 2) {
+      return "-(" + random(depth - 1) + ")";
+    } else if (choice == 3) {
+      return functions[rng() % functions.size()] + "(" + random(depth - 1) +
+             ")";
+    }
+    return "(" + random(depth - 1) + ")" + operators[rng() % operators.size()] +
+           "(" + random(depth - 1) + ")";
+  };
+  std::uniform_real_distribution<double> center(-20, 20), width(0, 3);
+
+  for (int round = 0; round < 400; ++round) {
+    std::string input = random(4);
+    s21::CompiledExpression expression = s21::Compile(input);
+    double low = center(rng), high = low + width(rng);
+    Interval y = expression.Enclose(low, high);
+    std::vector<double> xs(65), batch(xs.size());
+    for (size_t i = 0; i < xs.size(); ++i) {
+      xs[i] = i + 1 == xs.size() ? high : low + (high - low) * i / 64;
+    }
+    expression.EvaluateBatch(xs.data(), batch.data(), xs.size());
+    for (size_t i = 0; i < xs.size(); ++i) {
+      for (double value : {batch[i], expression.Evaluate(xs[i]),
+                           expression.EvaluateReference(xs[i])}) {
+        if (std::isnan(value)) {
+          ASSERT_TRUE(y.isPartial()) << input << " at " << xs[i];
+        } else {
+          ASSERT_TRUE(y.Contains(value))
+              << input << " at " << xs[i] << ": " << value << " not in ["
+              << y.low << ", " << y.high << "]";
+        }
+      }
+    }
+  }
+}
+
+TEST(IntervalTest, rangeSamplingSkipsHiddenBlocks) {
+  s21::CalculatorModel model;
+  for (const char *input : {"sqrt(x)", "x^2", "tan(x)", "ln(x-5)*x"}) {
+    auto xy = model.Calculate(input, -10, 10, -1, 1, 20000);
+    std::vector<double> expected(xy.first.size());
+    model.EvaluateBatch(input, xy.first.data(), expected.data(),
+                        expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      if (expected[i] >= -1 && expected[i] <= 1) {
+        ASSERT_EQ(xy.second[i], expected[i]) << input << " " << i;
+      } else {
+        ASSERT_TRUE(std::isnan(xy.second[i])) << input << " " << i;
+      }
+    }
+  }
+  model.Calculate("sqrt(x)", -10, 10, -1, 1, 20000);
+  EXPECT_LT(model.LastEvaluationCount(), 2000u);
+  model.Calculate("sqrt(x)", -10, 10, 0, 0, 20000);
+  EXPECT_EQ(model.LastEvaluationCount(), 20000u);
+}
+
+TEST(IntervalTest, samplerSkipsProvablyHiddenIntervals) {
+  s21::CalculatorModel model;
+  s21::CompiledExpression expression = model.Compile("sqrt(x - 5)*sin(x)");
+  auto evaluate = [&](const double *xs, double *out, size_t count) {
+    expression.EvaluateBatch(xs, out, count);
+  };
+  auto enclose = [&](double low, double high) {
+    return expression.Enclose(low, high);
+  };
+  s21::AdaptiveSampler plain, culled;
+  plain.Sample(evaluate, -20, 20, -0.5, 0.5);
+  auto actual = culled.Sample(evaluate, -20, 20, -0.5, 0.5, enclose);
+  EXPECT_LT(culled.Evaluations(), plain.Evaluations());
+  size_t visible = 0;
+  for (size_t i = 0; i < actual.first.size(); ++i) {
+    if (!std::isnan(actual.second[i])) ++visible;
+  }
+  EXPECT_GT(visible, 0u);
+  for (double y : actual.second) {
+    EXPECT_TRUE(std::isnan(y) || std::fabs(y) <= 0.5);
+  }
+}
+
+TEST(IntervalTest, estimatesPlotRange) {
+  s21::CalculatorModel model;
+  Interval range = model.EstimateRange("sin(x)", -10, 10);
+  EXPECT_LE(range.low, -1);
+  EXPECT_GE(range.high, 1);
+  EXPECT_LT(range.high, 1.001);
+  range = model.EstimateRange("x^2 - 3", -2, 2);
+  EXPECT_LE(range.low, -3);
+  EXPECT_GT(range.low, -3.2);
+  EXPECT_GE(range.high, 1);
+  EXPECT_LT(range.high, 1.2);
+  EXPECT_TRUE(model.EstimateRange("tan(x)", -5, 5).isBounded());
+  EXPECT_TRUE(model.EstimateRange("sqrt(-1-x^2)", -5, 5).isEmpty());
+}
+
+}  // namespace
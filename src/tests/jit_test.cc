@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/jit.h"
+#include "../model/program.h"
+#include "../model/thread_pool.h"
+
+namespace {
+
+using s21::Instruction;
+using s21::JitProgram;
+
+bool SameBits(double a, double b) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return std::isnan(a) && std::isnan(b);
+  }
+  uint64_t x, y;
+  std::memcpy(&x, &a, sizeof(x));
+  std::memcpy(&y, &b, sizeof(y));
+  return x == y;
+}
+
+class JitTest : public testing::Test {
+ protected:
+  std::mt19937_64 rng_{7};
+
+  std::string RandomExpression(int depth) {
+    static const std::vector<std::string> functions{
+        "sin",  "cos",  "tan",  "ctg", "asin",
+        "acos", "atan", "sqrt", "ln",  "log",
+    };
+    static const std::vector<std::string> operators{"+", "-", "*", "/", "^",
+                                                    " mod "};
+    size_t choice = rng_() % (depth > 0 ? 6 : 2);
+    if (choice == 0) {
+      return std::to_string(rng_() % 1000 / 100.0);
+    } else if (choice == 1) {
+      return "x";
+    } else if (choice == 2) {
+      return "-(" + RandomExpression(depth - 1) + ")";
+    } else if (choice == 3) {
+      return functions[rng_() % functions.size()] + "(" +
+             RandomExpression(depth - 1) + ")";
+    }
+    return "(" + RandomExpression(depth - 1) + ")" +
+           operators[rng_() % operators.size()] + "(" +
+           RandomExpression(depth - 1) + ")";
+  }
+};
+
+TEST_F(JitTest, availability) {
+  JitProgram empty;
+  EXPECT_FALSE(empty.isCompiled());
+#if defined(__x86_64__) && defined(__linux__)
+  const char *value = std::getenv(s21::kJitVariable);
+  if (!value || strcmp(value, "0")) {
+    EXPECT_TRUE(JitProgram::isAvailable());
+  }
+#endif
+}
+
+TEST_F(JitTest, matchesInterpreter) {
+  if (!JitProgram::isAvailable()) GTEST_SKIP();
+  s21::Program program;
+  program.PushX();
+  program.PushConstant(3);
+  program.Apply(Instruction::MOD);
+  program.PushX();
+  program.Apply(Instruction::NEG);
+  program.Apply(Instruction::SQRT);
+  program.Apply(Instruction::SUB);
+  program.PushX();
+  program.Apply(Instruction::SIN);
+  program.PushConstant(-0.5);
+  program.Apply(Instruction::POW);
+  program.Apply(Instruction::DIV);
+  JitProgram jit(program);
+  ASSERT_TRUE(jit.isCompiled());
+  EXPECT_GT(jit.CodeSize(), 0u);
+  for (double x = -20; x < 20; x += 0.173) {
+    EXPECT_TRUE(SameBits(jit.Evaluate(x), program.Evaluate(x))) << x;
+  }
+  for (double x :
+       {0.0, -0.0, HUGE_VAL, -HUGE_VAL, double(NAN), 1e308, -5e-324}) {
+    EXPECT_TRUE(SameBits(jit.Evaluate(x), program.Evaluate(x))) << x;
+  }
+}
+
+TEST_F(JitTest, emptyAndConstantPrograms) {
+  if (!JitProgram::isAvailable()) GTEST_SKIP();
+  s21::Program program;
+  EXPECT_EQ(JitProgram(program).Evaluate(5), 0);
+  program.PushConstant(-2.5);
+  EXPECT_EQ(JitProgram(program).Evaluate(5), -2.5);
+}
+
+TEST_F(JitTest, manySlots) {
+  if (!JitProgram::isAvailable()) GTEST_SKIP();
+  s21::Program program;
+  for (int i = 0; i < 300; ++i) {
+    program.PushX();
+    program.PushConstant(i);
+  }
+  for (int i = 0; i < 300; ++i) {
+    program.Apply(i % 2 ? Instruction::MUL : Instruction::ADD);
+    program.Apply(Instruction::COS);
+  }
+  program.Apply(Instruction::ADD);
+  ASSERT_GT(program.SlotCount(), 64u);
+  JitProgram jit(program);
+  ASSERT_TRUE(jit.isCompiled());
+  for (double x = -3; x < 3; x += 0.25) {
+    EXPECT_TRUE(SameBits(jit.Evaluate(x), program.Evaluate(x))) << x;
+  }
+
+  // Batches on several threads at once, each with slots of its own.
+  std::vector<double> xs(4096), out(xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) xs[i] = i * 0.001 - 2;
+  s21::ThreadPool pool(4);
+  pool.ParallelFor(xs.size(), 256, [&](size_t begin, size_t end) {
+    jit.EvaluateBatch(xs.data() + begin, out.data() + begin, end - begin);
+  });
+  for (size_t i = 0; i < xs.size(); ++i) {
+    ASSERT_TRUE(SameBits(out[i], program.Evaluate(xs[i]))) << xs[i];
+  }
+}
+
+TEST_F(JitTest, moveReleasesCode) {
+  if (!JitProgram::isAvailable()) GTEST_SKIP();
+  s21::Program program;
+  program.PushX();
+  program.Apply(Instruction::ATAN);
+  JitProgram first(program);
+  JitProgram second(std::move(first));
+  EXPECT_FALSE(first.isCompiled());
+  ASSERT_TRUE(second.isCompiled());
+  EXPECT_EQ(second.Evaluate(1), atan(1));
+  second = JitProgram();
+  EXPECT_FALSE(second.isCompiled());
+}
+
+TEST_F(JitTest, batchMatchesScalar) {
+  if (!JitProgram::isAvailable()) GTEST_SKIP();
+  s21::Program program;
+  program.PushX();
+  program.PushX();
+  program.Apply(Instruction::MUL);
+  program.PushConstant(1);
+  program.Apply(Instruction::ADD);
+  program.Apply(Instruction::LN);
+  JitProgram jit(program);
+  std::vector<double> xs(1000), out(xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) xs[i] = i * 0.01 - 5;
+  jit.EvaluateBatch(xs.data(), out.data(), xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) {
+    EXPECT_TRUE(SameBits(out[i], program.Evaluate(xs[i])));
+  }
+}
+
+TEST_F(JitTest, differentialAgainstReference) {
+  s21::CalculatorModel model;
+  for (int i = 0; i < 400; ++i) {
+    std::string expression = RandomExpression(5);
+    for (double x : {-7.5, -1.0, -0.25, 0.0, 0.5, 1.0, 2.0, 3.14, 42.0}) {
+      double expected = model.CalculateReference(expression, x);
+      double actual = model.Calculate(expression, x);
+      EXPECT_TRUE(SameBits(actual, expected))
+          << expression << " at " << x << ": " << actual << " vs "
+          << expected;
+    }
+  }
+}
+
+}  // namespace
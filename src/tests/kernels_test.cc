@@ -0,0 +1,279 @@
+#include <gtest/gtest.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../model/dispatch.h"
+#include "../model/kernels.h"
+#include "../model/program.h"
+
+namespace {
+
+using s21::Instruction;
+using s21::kernels::KernelTable;
+
+double FromBits(uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+int64_t Ordered(double value) {
+  int64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits < 0 ? INT64_MIN - bits : bits;
+}
+
+uint64_t UlpDistance(double a, double b) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return std::isnan(a) && std::isnan(b) ? 0 : UINT64_MAX;
+  }
+  if (a == b) return 0;
+  int64_t x = Ordered(a), y = Ordered(b);
+  return x > y ? uint64_t(x) - uint64_t(y) : uint64_t(y) - uint64_t(x);
+}
+
+std::vector<const KernelTable *> VectorTables() {
+  std::vector<const KernelTable *> tables;
+  for (int tier = s21::dispatch::SSE2; tier < s21::dispatch::TIER_END;
+       ++tier) {
+    if (s21::dispatch::isSupported(s21::dispatch::Tier(tier))) {
+      tables.push_back(&s21::dispatch::Table(s21::dispatch::Tier(tier)));
+    }
+  }
+  return tables;
+}
+
+const std::vector<double> kSpecials{
+    0.0,      -0.0,          1.0,       -1.0,     0.5,        -0.5,
+    2.0,      -2.0,          3.0,       -3.0,     HUGE_VAL,   -HUGE_VAL,
+    NAN,      -NAN,          DBL_MAX,   -DBL_MAX, DBL_MIN,    -DBL_MIN,
+    4.9e-324, -4.9e-324,     1e-300,    1e300,    M_PI,       M_PI_2,
+    -M_PI_2,  M_PI_4,        0x1p20,    -0x1p20,  0x1.00001p20, 1e22,
+    709.78,   -745.2,        1 + 1e-15, 1 - 1e-16, 0.41421356, 2.41421356,
+};
+
+class KernelTest : public testing::Test {
+ protected:
+  std::mt19937_64 rng_{20240917};
+  // Inputs per function and tier, on top of the special values; few enough
+  // for make tests, which runs under valgrind.
+  size_t samples_ = 1 << 14;
+
+  double Uniform(double low, double high) {
+    return std::uniform_real_distribution<double>(low, high)(rng_);
+  }
+
+  double AnyBits() { return FromBits(rng_()); }
+
+  double LogUniform(int low_exponent, int high_exponent) {
+    double magnitude = std::exp2(Uniform(low_exponent, high_exponent));
+    return rng_() & 1 ? magnitude : -magnitude;
+  }
+
+  std::vector<double> Uniforms(double low, double high) {
+    std::vector<double> values(kSpecials);
+    while (values.size() < samples_) {
+      values.push_back(Uniform(low, high));
+    }
+    return values;
+  }
+
+  std::vector<double> Magnitudes(int low_exponent, int high_exponent) {
+    std::vector<double> values(kSpecials);
+    while (values.size() < samples_) {
+      values.push_back(LogUniform(low_exponent, high_exponent));
+    }
+    return values;
+  }
+
+  std::vector<double> Bits() {
+    std::vector<double> values(kSpecials);
+    while (values.size() < samples_) {
+      values.push_back(AnyBits());
+    }
+    return values;
+  }
+
+  void CheckUnary(Instruction::OpCode op, const std::vector<double> &a,
+                  uint64_t max_ulp) {
+    std::vector<double> expected(a.size()), actual(a.size());
+    s21::kernels::Scalar().unary[op](a.data(), expected.data(), a.size());
+    for (const KernelTable *table : VectorTables()) {
+      table->unary[op](a.data(), actual.data(), a.size());
+      uint64_t worst = 0;
+      for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t ulp = UlpDistance(actual[i], expected[i]);
+        if (ulp > max_ulp) {
+          ADD_FAILURE() << table->name << " opcode " << int(op) << " at "
+                        << a[i] << ": " << actual[i] << " vs " << expected[i];
+          return;
+        }
+        worst = std::max(worst, ulp);
+      }
+      RecordProperty(std::string(table->name) + "_" + std::to_string(op),
+                     std::to_string(worst));
+    }
+  }
+
+  void CheckBinary(Instruction::OpCode op, const std::vector<double> &a,
+                   const std::vector<double> &b, uint64_t max_ulp) {
+    std::vector<double> expected(a.size()), actual(a.size());
+    s21::kernels::Scalar().binary[op](a.data(), b.data(), expected.data(),
+                                      a.size());
+    for (const KernelTable *table : VectorTables()) {
+      table->binary[op](a.data(), b.data(), actual.data(), a.size());
+      uint64_t worst = 0;
+      for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t ulp = UlpDistance(actual[i], expected[i]);
+        if (ulp > max_ulp) {
+          ADD_FAILURE() << table->name << " opcode " << int(op) << " at "
+                        << a[i] << ", " << b[i] << ": " << actual[i]
+                        << " vs " << expected[i];
+          return;
+        }
+        worst = std::max(worst, ulp);
+      }
+      RecordProperty(std::string(table->name) + "_" + std::to_string(op),
+                     std::to_string(worst));
+    }
+  }
+
+  std::vector<double> Shuffled(std::vector<double> values) {
+    std::shuffle(values.begin(), values.end(), rng_);
+    return values;
+  }
+
+  void Trigonometry() {
+    for (auto op : {Instruction::SIN, Instruction::COS}) {
+      CheckUnary(op, Uniforms(-10, 10), 2);
+      CheckUnary(op, Magnitudes(-40, 24), 2);
+    }
+    for (auto op : {Instruction::TAN, Instruction::COTAN}) {
+      CheckUnary(op, Uniforms(-10, 10), 4);
+      CheckUnary(op, Magnitudes(-40, 24), 4);
+    }
+  }
+
+  void InverseTrigonometry() {
+    CheckUnary(Instruction::ATAN, Magnitudes(-1074, 1024), 2);
+    CheckUnary(Instruction::ATAN, Uniforms(-4, 4), 2);
+    for (auto op : {Instruction::ASIN, Instruction::ACOS}) {
+      CheckUnary(op, Uniforms(-1.25, 1.25), 3);
+      CheckUnary(op, Magnitudes(-60, 1), 3);
+    }
+  }
+
+  void Logarithms() {
+    for (auto op : {Instruction::LN, Instruction::LOG}) {
+      uint64_t bound = op == Instruction::LN ? 2 : 4;
+      CheckUnary(op, Bits(), bound);
+      CheckUnary(op, Uniforms(0.5, 2), bound);
+      CheckUnary(op, Magnitudes(-1074, 1024), bound);
+    }
+  }
+
+  void SqrtAndArithmetic() {
+    CheckUnary(Instruction::SQRT, Bits(), 0);
+    CheckUnary(Instruction::NEG, Bits(), 0);
+    for (auto op : {Instruction::ADD, Instruction::SUB, Instruction::MUL,
+                    Instruction::DIV}) {
+      CheckBinary(op, Bits(), Shuffled(Bits()), 0);
+    }
+  }
+
+  void Pow() {
+    CheckBinary(Instruction::POW, Magnitudes(-20, 20), Uniforms(-40, 40), 2);
+    CheckBinary(Instruction::POW, Uniforms(0, 1000), Uniforms(-100, 100), 2);
+    std::vector<double> integers = Uniforms(-30, 30);
+    for (double &y : integers) y = std::round(y);
+    CheckBinary(Instruction::POW, Uniforms(-10, 10), integers, 2);
+    CheckBinary(Instruction::POW, Shuffled(Bits()), Bits(), 2);
+  }
+
+  void Mod() {
+    CheckBinary(Instruction::MOD, Uniforms(-1e6, 1e6), Uniforms(-100, 100), 0);
+    CheckBinary(Instruction::MOD, Magnitudes(-80, 80),
+                Shuffled(Magnitudes(-80, 80)), 0);
+  }
+};
+
+// The same sweeps over a million inputs each, run by make benchmark.
+class KernelSweepBenchmark : public KernelTest {
+ protected:
+  KernelSweepBenchmark() { samples_ = 1 << 20; }
+};
+
+TEST_F(KernelTest, trigonometry) { Trigonometry(); }
+TEST_F(KernelTest, inverseTrigonometry) { InverseTrigonometry(); }
+TEST_F(KernelTest, logarithms) { Logarithms(); }
+TEST_F(KernelTest, sqrtAndArithmetic) { SqrtAndArithmetic(); }
+TEST_F(KernelTest, pow) { Pow(); }
+TEST_F(KernelTest, mod) { Mod(); }
+
+TEST_F(KernelSweepBenchmark, trigonometry) { Trigonometry(); }
+TEST_F(KernelSweepBenchmark, inverseTrigonometry) { InverseTrigonometry(); }
+TEST_F(KernelSweepBenchmark, logarithms) { Logarithms(); }
+TEST_F(KernelSweepBenchmark, sqrtAndArithmetic) { SqrtAndArithmetic(); }
+TEST_F(KernelSweepBenchmark, pow) { Pow(); }
+TEST_F(KernelSweepBenchmark, mod) { Mod(); }
+
+TEST_F(KernelTest, unalignedTailsAndAliasing) {
+  std::vector<double> values = Uniforms(-3, 3);
+  for (const KernelTable *table : VectorTables()) {
+    for (size_t count = 0; count < 20; ++count) {
+      std::vector<double> expected(values.begin() + 1,
+                                   values.begin() + 1 + count);
+      s21::kernels::Scalar().unary[Instruction::SIN](
+          expected.data(), expected.data(), count);
+      std::vector<double> actual(values.begin() + 1,
+                                 values.begin() + 1 + count);
+      table->unary[Instruction::SIN](actual.data(), actual.data(), count);
+      for (size_t i = 0; i < count; ++i) {
+        EXPECT_LE(UlpDistance(actual[i], expected[i]), 2u) << table->name;
+      }
+    }
+  }
+}
+
+TEST_F(KernelTest, programBatchWithScalarTableIsExact) {
+  s21::Program program;
+  program.PushX();
+  program.Apply(Instruction::SIN);
+  program.PushX();
+  program.PushConstant(3);
+  program.Apply(Instruction::MOD);
+  program.Apply(Instruction::POW);
+  std::vector<double> xs = Uniforms(-20, 20), out(xs.size());
+  program.EvaluateBatch(xs.data(), out.data(), xs.size(),
+                        &s21::kernels::Scalar());
+  for (size_t i = 0; i < xs.size(); ++i) {
+    EXPECT_EQ(UlpDistance(out[i], program.Evaluate(xs[i])), 0u);
+  }
+}
+
+TEST_F(KernelTest, dispatchSelection) {
+  using namespace s21::dispatch;
+  EXPECT_TRUE(isSupported(SCALAR));
+  EXPECT_TRUE(isSupported(BestTier()));
+  EXPECT_EQ(SelectTier(nullptr), BestTier());
+  EXPECT_EQ(SelectTier("scalar"), SCALAR);
+  EXPECT_EQ(SelectTier("no-such-tier"), BestTier());
+  for (int i = 0; i < TIER_END; ++i) {
+    Tier tier = Tier(i), parsed;
+    ASSERT_TRUE(ParseTier(TierName(tier), parsed));
+    EXPECT_EQ(parsed, tier);
+    Tier expected = isSupported(tier) ? tier : BestTier();
+    EXPECT_EQ(SelectTier(TierName(tier)), expected);
+    if (isSupported(tier)) {
+      EXPECT_STREQ(Table(tier).name, TierName(tier));
+    }
+  }
+  EXPECT_STREQ(Active().name, TierName(ActiveTier()));
+}
+
+}  // namespace
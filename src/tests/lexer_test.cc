@@ -0,0 +1,329 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/trie.h"
+
+namespace {
+
+using s21::Lexeme;
+
+using Trie = s21::StaticTrie<int, 16>;
+constexpr std::array<Trie::Word, 5> kWords{{
+    {"co", 1}, {"cos", 2}, {"cotan", 3}, {"x", 4}, {"+", 5},
+}};
+constexpr Trie kTrie{kWords};
+
+constexpr size_t MatchLength(const char *input) {
+  int value = 0;
+  return kTrie.Match(input, value);
+}
+
+static_assert(MatchLength("cotan(x)") == 5, "longest match");
+static_assert(MatchLength("cosx") == 3, "prefix word");
+static_assert(MatchLength("cot") == 2, "falls back to shorter word");
+static_assert(MatchLength("c") == 0, "inner node is not a word");
+static_assert(MatchLength("") == 0, "end of input");
+static_assert([] {
+  int value = 0;
+  return kTrie.Match(std::string_view("cotan", 3), value);
+}() == 2, "stops at the end of the view");
+
+TEST(LexerTest, longestMatch) {
+  int value = 0;
+  EXPECT_EQ(kTrie.Match("cotangent", value), 5u);
+  EXPECT_EQ(value, 3);
+  EXPECT_EQ(kTrie.Match("cos(", value), 3u);
+  EXPECT_EQ(value, 2);
+  EXPECT_EQ(kTrie.Match("cox", value), 2u);
+  EXPECT_EQ(value, 1);
+  value = 0;
+  EXPECT_EQ(kTrie.Match("sin", value), 0u);
+  EXPECT_EQ(kTrie.Match("\xff", value), 0u);
+  EXPECT_EQ(value, 0);
+  EXPECT_EQ(kTrie.NodeCount(), 9u);
+}
+
+TEST(LexerTest, everyName) {
+  s21::CalculatorModel model;
+  std::vector<Lexeme> lexemes = model.Tokenize(
+      "cotan(x)+ctg(X)-tg(x)^tan(x)*acos(x)/asin(x)%atan(x) mod sqrt(x) "
+      "mod ln(x)-log(x)+cos(x)*sin(x)");
+  std::vector<Lexeme::Type> expected{
+      Lexeme::COTAN, Lexeme::LEFTPAR,  Lexeme::XNUM,  Lexeme::RIGHTPAR,
+      Lexeme::ADD,   Lexeme::COTAN,    Lexeme::LEFTPAR, Lexeme::XNUM,
+      Lexeme::RIGHTPAR, Lexeme::SUB,   Lexeme::TAN,   Lexeme::LEFTPAR,
+      Lexeme::XNUM,  Lexeme::RIGHTPAR, Lexeme::POW,   Lexeme::TAN,
+      Lexeme::LEFTPAR, Lexeme::XNUM,   Lexeme::RIGHTPAR, Lexeme::MUL,
+      Lexeme::ACOS,  Lexeme::LEFTPAR,  Lexeme::XNUM,  Lexeme::RIGHTPAR,
+      Lexeme::DIV,   Lexeme::ASIN,     Lexeme::LEFTPAR, Lexeme::XNUM,
+      Lexeme::RIGHTPAR, Lexeme::MOD,   Lexeme::ATAN,  Lexeme::LEFTPAR,
+      Lexeme::XNUM,  Lexeme::RIGHTPAR, Lexeme::MOD,   Lexeme::SQRT,
+      Lexeme::LEFTPAR, Lexeme::XNUM,   Lexeme::RIGHTPAR, Lexeme::MOD,
+      Lexeme::LN,    Lexeme::LEFTPAR,  Lexeme::XNUM,  Lexeme::RIGHTPAR,
+      Lexeme::SUB,   Lexeme::LOG,      Lexeme::LEFTPAR, Lexeme::XNUM,
+      Lexeme::RIGHTPAR, Lexeme::ADD,   Lexeme::COS,   Lexeme::LEFTPAR,
+      Lexeme::XNUM,  Lexeme::RIGHTPAR, Lexeme::MUL,   Lexeme::SIN,
+      Lexeme::LEFTPAR, Lexeme::XNUM,   Lexeme::RIGHTPAR,
+  };
+  ASSERT_EQ(lexemes.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(lexemes[i].type, expected[i]) << i;
+  }
+  EXPECT_THROW(model.Tokenize("sinh(x)"), std::invalid_argument);
+  EXPECT_THROW(model.Tokenize("co(x)"), std::invalid_argument);
+}
+
+using NameTrie = s21::StaticTrie<int, 64>;
+constexpr std::array<NameTrie::Word, 23> kNames{{
+    {"+", 0},    {"-", 1},     {"x", 2},     {"X", 3},    {"^", 4},
+    {"*", 5},    {"/", 6},     {"%", 7},     {"mod", 8},  {"(", 9},
+    {")", 10},   {"cos", 11},  {"sin", 12},  {"ctg", 13}, {"cotan", 14},
+    {"tg", 15},  {"tan", 16},  {"acos", 17}, {"asin", 18}, {"atan", 19},
+    {"sqrt", 20}, {"ln", 21},  {"log", 22},
+}};
+constexpr NameTrie kNameTrie{kNames};
+
+// Name-only scans with the trie and with the strncmp loop it replaced, so the
+// lookup itself can be compared without building lexemes.
+size_t TrieScan(const std::string &input) {
+  size_t count = 0;
+  int value = 0;
+  for (size_t pos = 0; pos < input.size();) {
+    if (input[pos] == ' ') {
+      ++pos;
+    } else {
+      pos += kNameTrie.Match(std::string_view(input).substr(pos), value);
+      ++count;
+    }
+  }
+  return count;
+}
+
+size_t LinearScan(const std::string &input) {
+  size_t count = 0;
+  for (const char *cur = input.data(); *cur;) {
+    if (*cur == ' ') {
+      ++cur;
+      continue;
+    }
+    for (const NameTrie::Word &name : kNames) {
+      if (!strncmp(cur, name.first.data(), name.first.size())) {
+        cur += name.first.size();
+        ++count;
+        break;
+      }
+    }
+  }
+  return count;
+}
+
+TEST(LexerTest, tryCompileReportsErrors) {
+  s21::CalculatorModel model;
+  struct Case {
+    const char *input;
+    s21::ErrorCode code;
+    size_t position;
+  };
+  for (const Case &c : std::vector<Case>{
+           {"x + @", s21::INCORRECT_LEXEME, 4},
+           {"1 + .", s21::INCORRECT_NUMBER, 4},
+           {"1e999 + x", s21::INCORRECT_NUMBER, 0},
+           {"2 * sin(x", s21::UNCLOSED_PARENT, 0},
+           {"(x))", s21::UNOPENED_PARENT, 3},
+           {"2 +", s21::NOT_ENOUGH_OPERANDS, 0},
+           {"2 3", s21::MORE_NUMBERS_THAN_EXPECTED, 0},
+       }) {
+    s21::CompiledExpression out;
+    s21::ParseStatus status = model.TryCompile(c.input, out);
+    EXPECT_EQ(status.code, c.code) << c.input;
+    EXPECT_EQ(status.position, c.position) << c.input;
+    EXPECT_TRUE(out.isEmpty()) << c.input;
+    EXPECT_EQ(model.Prepare(c.input).code, c.code) << c.input;
+    try {
+      model.Compile(c.input);
+      ADD_FAILURE() << c.input;
+    } catch (std::invalid_argument &e) {
+      EXPECT_EQ(e.what(), status.Message()) << c.input;
+    }
+  }
+
+  s21::CompiledExpression out;
+  EXPECT_TRUE(s21::TryCompile("2 * x", out).isOk());
+  EXPECT_EQ(out.Evaluate(4), 8);
+  EXPECT_TRUE(s21::TryCompile("", out).isOk());
+  EXPECT_TRUE(model.Prepare("sin(x)").isOk());
+  EXPECT_DOUBLE_EQ(model.Calculate("sin(x)", 1), std::sin(1));
+}
+
+TEST(LexerTest, numbers) {
+  s21::CalculatorModel model;
+  EXPECT_EQ(model.Calculate(".5 + 5."), 5.5);
+  EXPECT_EQ(model.Calculate("2.5e3 - 1E-2"), 2499.99);
+  EXPECT_EQ(model.Calculate("1e-310"), 1e-310);
+  EXPECT_EQ(model.Calculate("000120"), 120);
+  EXPECT_EQ(model.Calculate("2e+2*x", 2), 400);
+  // A trailing exponent marker is not part of the number.
+  EXPECT_THROW(model.Calculate("1e"), std::invalid_argument);
+  std::string input = "1.25";
+  std::vector<s21::Lexeme> lexemes =
+      model.Tokenize(std::string(input.data(), 3));
+  ASSERT_EQ(lexemes.size(), 1u);
+  EXPECT_EQ(lexemes[0].num, 1.2);
+}
+
+TEST(LexerTest, editsMatchFullCompile) {
+  const std::string alphabet = "0123456789.e+-*/^() xXsincotagqrlm%";
+  std::mt19937 rng(7);
+  s21::CalculatorModel model;
+  s21::CalculatorModel reference;
+  std::string input;
+  for (int round = 0; round < 20000; ++round) {
+    size_t pos = input.empty() ? 0 : rng() % (input.size() + 1);
+    if (rng() % 3 || input.empty()) {
+      input.insert(pos, 1 + rng() % 3, alphabet[rng() % alphabet.size()]);
+    } else {
+      input.erase(pos, 1 + rng() % 4);
+    }
+    if (input.size() > 40) {
+      input.erase(rng() % input.size());
+    }
+    bool changed = false;
+    s21::ParseStatus status = model.PrepareEdit(input, changed);
+    s21::CompiledExpression expected;
+    s21::ParseStatus expected_status = reference.TryCompile(input, expected);
+    ASSERT_EQ(status.code, expected_status.code) << input;
+    ASSERT_EQ(status.position, expected_status.position) << input;
+    if (status.isOk()) {
+      double actual = model.Calculate(input, 0.7);
+      double value = expected.Evaluate(0.7);
+      ASSERT_TRUE(actual == value || (std::isnan(actual) && std::isnan(value)))
+          << input;
+    }
+  }
+}
+
+TEST(LexerTest, editsRelexOnlyTheEditedSpan) {
+  s21::CalculatorModel model;
+  std::string input;
+  for (int i = 0; i < 200; ++i) {
+    input += "sin(x)*2.5+";
+  }
+  input += "x";
+  bool changed = false;
+  ASSERT_TRUE(model.PrepareEdit(input, changed).isOk());
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(model.LastRelexedLength(), input.size());
+
+  // Typing a new name one character at a time in the middle.
+  std::string typed = input;
+  size_t middle = 100 * 11;
+  for (char c : std::string("cos(x)-")) {
+    typed.insert(middle++, 1, c);
+    model.PrepareEdit(typed, changed);
+    EXPECT_LE(model.LastRelexedLength(), 16u) << typed;
+  }
+  ASSERT_TRUE(model.PrepareEdit(typed, changed).isOk());
+  EXPECT_FALSE(changed);
+  EXPECT_NEAR(model.Calculate(typed, 1),
+              198 * std::sin(1) * 2.5 + std::cos(1) + 1, 1e-10);
+
+  // Whitespace and an unfinished name leave the expression as it was.
+  typed.insert(middle, "  ");
+  ASSERT_TRUE(model.PrepareEdit(typed, changed).isOk());
+  EXPECT_FALSE(changed);
+  std::string unfinished = typed + "+co";
+  EXPECT_EQ(model.PrepareEdit(unfinished, changed).code,
+            s21::INCORRECT_LEXEME);
+  ASSERT_TRUE(model.PrepareEdit(typed, changed).isOk());
+  EXPECT_FALSE(changed);
+  EXPECT_TRUE(model.PrepareEdit(typed + "+1", changed).isOk());
+  EXPECT_TRUE(changed);
+}
+
+// Throughput on a few megabytes of generated names and operators, reported
+// as test properties and on stdout by make benchmark.
+TEST(LexerBenchmark, throughput) {
+  const std::vector<std::string> pieces{
+      "sin(x)", "cos(x)", "cotan(x)", "acos(x)", "atan(x)", "sqrt(x)",
+      "ln(x)",  "log(x)", "x",        "-x",      "tg(x)",   "(x mod X)",
+  };
+  const std::vector<std::string> operators{"+", "-", "*", "/", "^"};
+  std::mt19937 rng(3);
+  std::string input;
+  while (input.size() < (4 << 20)) {
+    input += pieces[rng() % pieces.size()];
+    input += operators[rng() % operators.size()];
+  }
+  input += "x";
+
+  using Clock = std::chrono::steady_clock;
+  s21::CalculatorModel model;
+  auto start = Clock::now();
+  std::vector<Lexeme> lexemes = model.Tokenize(input);
+  double tokenize =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  start = Clock::now();
+  size_t matched = TrieScan(input);
+  double trie = std::chrono::duration<double>(Clock::now() - start).count();
+  start = Clock::now();
+  size_t scanned = LinearScan(input);
+  double linear = std::chrono::duration<double>(Clock::now() - start).count();
+
+  EXPECT_EQ(lexemes.size(), matched);
+  EXPECT_EQ(lexemes.size(), scanned);
+  double megabytes = input.size() / 1e6;
+  std::cout << "[ lexer    ] " << megabytes / tokenize << " MB/s tokenizing, "
+            << megabytes / trie << " MB/s trie name scan, "
+            << megabytes / linear << " MB/s linear name scan\n";
+  RecordProperty("tokenize_mb_per_s", std::to_string(megabytes / tokenize));
+  RecordProperty("trie_scan_mb_per_s", std::to_string(megabytes / trie));
+  RecordProperty("linear_scan_mb_per_s", std::to_string(megabytes / linear));
+}
+
+// The same with numbers mixed in, which must stay linear in the input size.
+TEST(LexerBenchmark, numberThroughput) {
+  const std::vector<std::string> pieces{
+      "3.14159", "2.5e-3", "42", "0.001", "x", "sin(1.5*x)", "(x mod 7)",
+  };
+  const std::vector<std::string> operators{"+", "-", "*", "/", "^"};
+  std::mt19937 rng(5);
+  std::string input;
+  size_t numbers = 0;
+  while (input.size() < (4 << 20)) {
+    size_t piece = rng() % pieces.size();
+    numbers += piece < 4 || piece == 5 || piece == 6;
+    input += pieces[piece];
+    input += operators[rng() % operators.size()];
+  }
+  input += "1";
+  ++numbers;
+
+  s21::CalculatorModel model;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Lexeme> lexemes = model.Tokenize(input);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  size_t parsed = 0;
+  for (const Lexeme &lexeme : lexemes) {
+    parsed += lexeme.type == Lexeme::NUM;
+  }
+  EXPECT_EQ(parsed, numbers);
+  double megabytes = input.size() / 1e6;
+  std::cout << "[ lexer    ] " << megabytes / seconds
+            << " MB/s tokenizing with numbers\n";
+  RecordProperty("number_tokenize_mb_per_s",
+                 std::to_string(megabytes / seconds));
+}
+
+}  // namespace
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/native.h"
+#include "../model/program.h"
+
+namespace {
+
+using s21::Instruction;
+using s21::NativeProgram;
+
+class NativeTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = std::filesystem::temp_directory_path() /
+                 ("smartcalc_native_test_" + std::to_string(getpid()));
+    setenv(s21::kNativeCacheVariable, directory_.c_str(), 1);
+  }
+
+  void TearDown() override {
+    unsetenv(s21::kNativeCacheVariable);
+    std::filesystem::remove_all(directory_);
+  }
+
+  std::filesystem::path directory_;
+};
+
+TEST_F(NativeTest, generatesSource) {
+  s21::Program program;
+  program.PushX();
+  program.PushConstant(-0.5);
+  program.Apply(Instruction::POW);
+  program.Apply(Instruction::COTAN);
+  std::string source = NativeProgram::GenerateSource(program);
+  EXPECT_NE(source.find("pow(t0, t1)"), std::string::npos) << source;
+  EXPECT_NE(source.find("-0x1p-1"), std::string::npos) << source;
+  EXPECT_NE(source.find("1 / tan(t2)"), std::string::npos) << source;
+  EXPECT_NE(source.find("out[i] = t3;"), std::string::npos) << source;
+  EXPECT_EQ(NativeProgram::NormalizeExpression(" X * 2\t+ sin( x )"),
+            "x*2+sin(x)");
+}
+
+TEST_F(NativeTest, matchesInterpreterAndCaches) {
+  s21::Program program;
+  program.PushX();
+  program.Apply(Instruction::SIN);
+  program.PushX();
+  program.PushConstant(HUGE_VAL);
+  program.Apply(Instruction::MOD);
+  program.Apply(Instruction::ADD);
+  program.PushX();
+  program.Apply(Instruction::LOG);
+  program.Apply(Instruction::MUL);
+  NativeProgram native(program, "(sin(x) + x mod inf) * log(x)");
+  if (!native.isLoaded()) GTEST_SKIP() << "no system compiler";
+  EXPECT_FALSE(native.isFromCache());
+  EXPECT_TRUE(std::filesystem::exists(native.Path()));
+
+  std::vector<double> xs(1000), out(xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) xs[i] = i * 0.37 - 100;
+  native.EvaluateBatch(xs.data(), out.data(), xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) {
+    double expected = program.Evaluate(xs[i]);
+    if (std::isnan(expected)) {
+      EXPECT_TRUE(std::isnan(out[i])) << xs[i];
+    } else {
+      EXPECT_EQ(out[i], expected) << xs[i];
+    }
+  }
+
+  NativeProgram cached(program, "(sin(x)+x mod inf)*log(X)");
+  ASSERT_TRUE(cached.isLoaded());
+  EXPECT_TRUE(cached.isFromCache());
+  EXPECT_EQ(cached.Path(), native.Path());
+}
+
+TEST_F(NativeTest, staleCacheIsRebuilt) {
+  s21::Program program;
+  program.PushX();
+  program.Apply(Instruction::NEG);
+  NativeProgram first(program, "-x");
+  if (!first.isLoaded()) GTEST_SKIP() << "no system compiler";
+  program.Clear();
+  program.PushX();
+  program.Apply(Instruction::SQRT);
+  NativeProgram second(program, "-x");
+  ASSERT_TRUE(second.isLoaded());
+  EXPECT_FALSE(second.isFromCache());
+  double x = 4, y = 0;
+  second.EvaluateBatch(&x, &y, 1);
+  EXPECT_EQ(y, 2);
+}
+
+TEST_F(NativeTest, modelBatchUsesNativeCode) {
+  s21::CalculatorModel model;
+  model.EnableNativeCode(true);
+  std::string expression = "x^3 - 2*x + sqrt(x*x + 1)";
+  std::vector<double> xs{-3, -1, 0, 0.5, 7}, out(xs.size());
+  model.EvaluateBatch(expression, xs.data(), out.data(), xs.size());
+  if (!model.isUsingNativeCode()) GTEST_SKIP() << "no system compiler";
+  for (size_t i = 0; i < xs.size(); ++i) {
+    EXPECT_EQ(out[i], model.CalculateReference(expression, xs[i]));
+  }
+  model.EnableNativeCode(false);
+  model.EvaluateBatch(expression, xs.data(), out.data(), xs.size());
+  EXPECT_FALSE(model.isUsingNativeCode());
+}
+
+TEST_F(NativeTest, missingCompilerFallsBack) {
+  setenv(s21::kNativeCompilerVariable, "/nonexistent/cc", 1);
+  s21::Program program;
+  program.PushX();
+  NativeProgram native(program, "x+0*1");
+  unsetenv(s21::kNativeCompilerVariable);
+  EXPECT_FALSE(native.isLoaded());
+
+  s21::CalculatorModel model;
+  setenv(s21::kNativeCompilerVariable, "/nonexistent/cc", 1);
+  model.EnableNativeCode(true);
+  double x = 2, y = 0;
+  model.EvaluateBatch("x*x+1", &x, &y, 1);
+  unsetenv(s21::kNativeCompilerVariable);
+  EXPECT_FALSE(model.isUsingNativeCode());
+  EXPECT_EQ(y, 5);
+}
+
+}  // namespace
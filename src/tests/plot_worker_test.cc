@@ -0,0 +1,367 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/plot_worker.h"
+
+namespace {
+
+// Collects delivered results and lets the test wait for them.
+class Inbox {
+ public:
+  s21::PlotWorker::Callback Callback() {
+    return [this](s21::PlotResult &&result) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      results_.push_back(std::move(result));
+      arrived_.notify_all();
+    };
+  }
+
+  bool WaitFor(size_t id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return arrived_.wait_for(lock, std::chrono::seconds(30), [&] {
+      return !results_.empty() && results_.back().id == id &&
+             !results_.back().provisional;
+    });
+  }
+
+  std::vector<s21::PlotResult> Results() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return results_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable arrived_;
+  std::vector<s21::PlotResult> results_;
+};
+
+s21::PlotRequest Request(const char *input, size_t max_points = 4000) {
+  s21::PlotRequest request;
+  request.input = input;
+  request.low_x = -10;
+  request.high_x = 10;
+  request.sampling.max_points = max_points;
+  return request;
+}
+
+// Takes a few tenths of a second, long enough to still be running when the
+// next requests arrive.
+s21::PlotRequest SlowRequest() {
+  s21::PlotRequest request = Request("sin(1/x)*tan(x)^2", 1000000);
+  request.sampling.initial_points = 100000;
+  request.sampling.width = 1e7;
+  request.sampling.tolerance = 1e-9;
+  request.sampling.max_depth = 64;
+  return request;
+}
+
+TEST(PlotWorkerTest, matchesSynchronousModel) {
+  Inbox inbox;
+  s21::PlotWorker worker(2);
+  worker.SetCallback(inbox.Callback());
+  size_t id = worker.Submit(Request("sin(x)*x"));
+  ASSERT_TRUE(inbox.WaitFor(id));
+
+  s21::PlotResult result = inbox.Results().back();
+  s21::CalculatorModel model;
+  auto xy = model.CalculateAdaptive("sin(x)*x", -10, 10, 0, 0,
+                                    Request("", 4000).sampling);
+  EXPECT_TRUE(result.status.isOk());
+  EXPECT_EQ(result.x, xy.first);
+  EXPECT_EQ(result.y.size(), xy.second.size());
+  EXPECT_EQ(result.roots, model.FindRoots("sin(x)*x", -10, 10));
+  EXPECT_EQ(result.extrema.size(),
+            model.FindExtrema("sin(x)*x", -10, 10).size());
+  EXPECT_EQ(result.integral.value,
+            model.Integrate("sin(x)*x", -10, 10).value);
+  EXPECT_TRUE(result.range.isBounded());
+  EXPECT_EQ(result.request.input, "sin(x)*x");
+  EXPECT_EQ(worker.Completed(), 1u);
+
+  id = worker.Submit(Request("x +"));
+  ASSERT_TRUE(inbox.WaitFor(id));
+  EXPECT_EQ(inbox.Results().back().status.code, s21::NOT_ENOUGH_OPERANDS);
+  EXPECT_TRUE(inbox.Results().back().x.empty());
+}
+
+TEST(PlotWorkerTest, samplesOnASharedPool) {
+  s21::CalculatorModel model;
+  model.EnableParallelSampling(true, 3);
+  std::shared_ptr<s21::ThreadPool> pool = model.SamplingPool();
+  ASSERT_TRUE(pool);
+  Inbox inbox;
+  {
+    s21::PlotWorker worker(pool);
+    worker.SetCallback(inbox.Callback());
+    EXPECT_EQ(pool.use_count(), 3);
+    size_t id = worker.Submit(Request("sin(x)*x", 100000));
+    auto xy = model.Calculate("sin(x)*x", -10, 10, 0, 0, 100000);
+    ASSERT_TRUE(inbox.WaitFor(id));
+    EXPECT_EQ(xy.first.size(), 100000u);
+    EXPECT_TRUE(inbox.Results().back().status.isOk());
+  }
+  EXPECT_EQ(pool.use_count(), 2);
+
+  s21::CalculatorModel sequential;
+  sequential.ShareSamplingPool(nullptr);
+  EXPECT_EQ(sequential.SamplingThreads(), 1u);
+  sequential.ShareSamplingPool(pool);
+  EXPECT_EQ(sequential.SamplingThreads(), 3u);
+}
+
+TEST(PlotWorkerTest, latestRequestWins) {
+  Inbox inbox;
+  s21::PlotWorker worker(2);
+  worker.SetCallback(inbox.Callback());
+  size_t first = worker.Submit(SlowRequest());
+  std::vector<size_t> ids{first};
+  for (const char *input : {"x", "x^2", "x^3"}) {
+    ids.push_back(worker.Submit(Request(input)));
+  }
+  EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+  ASSERT_TRUE(inbox.WaitFor(ids.back()));
+
+  std::vector<s21::PlotResult> results = inbox.Results();
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0].request.input, "x^3");
+  EXPECT_EQ(worker.Completed(), 1u);
+  EXPECT_EQ(worker.Cancelled(), 3u);
+}
+
+TEST(PlotWorkerTest, cancelsOnDestruction) {
+  auto start = std::chrono::steady_clock::now();
+  {
+    s21::PlotWorker worker(2);
+    std::atomic<bool> delivered{false};
+    worker.SetCallback([&](s21::PlotResult &&) { delivered = true; });
+    worker.Submit(SlowRequest());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    worker.Cancel();
+    worker.SetCallback(nullptr);
+    EXPECT_FALSE(delivered);
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(PlotWorkerTest, tiledPansSampleOnlyNewTiles) {
+  Inbox inbox;
+  auto tiles = std::make_shared<s21::TileCache>();
+  s21::PlotWorker worker(2, s21::ExpressionCache::Shared(), tiles);
+  worker.SetCallback(inbox.Callback());
+  s21::CalculatorModel model;
+  s21::PlotRequest request = Request("sin(x)*x");
+  request.sampling = s21::ViewportSampling(800, 600, 1, 100000);
+  request.low_y = -5;
+  request.high_y = 5;
+  // 800 pixels over 20 units: tiles of 8 units, -2 to 1 in view.
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  s21::TileCache::Statistics stats = tiles->Stats();
+  EXPECT_EQ(stats.hits, 0u);
+  EXPECT_EQ(stats.misses, 4u);
+
+  // Tiles 0 to 2, of which 2 is new; the refill after the provisional
+  // result does not count 0 and 1 again.
+  request.low_x += 10;
+  request.high_x += 10;
+  size_t id = worker.Submit(request);
+  ASSERT_TRUE(inbox.WaitFor(id));
+  stats = tiles->Stats();
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.misses, 5u);
+  EXPECT_EQ(stats.stand_ins, 0u);
+  EXPECT_DOUBLE_EQ(stats.HitRatio(), 2.0 / 7);
+  std::vector<s21::PlotResult> results = inbox.Results();
+  ASSERT_EQ(results.size(), 3u);
+  for (size_t k = 1; k < 3; ++k) {
+    const s21::PlotResult &result = results[k];
+    EXPECT_EQ(result.id, id);
+    EXPECT_EQ(result.provisional, k == 1);
+    ASSERT_FALSE(result.x.empty());
+    EXPECT_TRUE(std::is_sorted(result.x.begin(), result.x.end()));
+    EXPECT_LE(result.x.front(), request.low_x);
+    EXPECT_GE(result.x.back(), request.high_x);
+    for (size_t i = 0; i < result.x.size(); ++i) {
+      double y = model.Calculate("sin(x)*x", result.x[i]);
+      if (std::isnan(result.y[i])) {
+        EXPECT_TRUE(k == 1 || !(std::fabs(y) <= 5)) << result.x[i];
+      } else {
+        EXPECT_DOUBLE_EQ(result.y[i], y);
+      }
+    }
+  }
+  EXPECT_TRUE(results[2].status.isOk());
+  EXPECT_FALSE(results[2].roots.empty());
+}
+
+TEST(PlotWorkerTest, tilesFollowSamplingOptions) {
+  Inbox inbox;
+  auto tiles = std::make_shared<s21::TileCache>();
+  s21::PlotWorker worker(2, s21::ExpressionCache::Shared(), tiles);
+  worker.SetCallback(inbox.Callback());
+  s21::PlotRequest request = Request("sin(x)*x");
+  request.sampling = s21::ViewportSampling(800, 600, 1, 100000);
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  size_t sampled = tiles->Stats().misses;
+  ASSERT_GT(sampled, 0u);
+
+  // Fewer points, then a finer tolerance: every tile again, and not shown
+  // from the tiles of other options meanwhile.
+  request.sampling = s21::ViewportSampling(800, 600, 1, 400);
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  EXPECT_EQ(tiles->Stats().misses, 2 * sampled);
+  request.sampling.tolerance /= 2;
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  EXPECT_EQ(tiles->Stats().misses, 3 * sampled);
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  EXPECT_EQ(tiles->Stats().misses, 3 * sampled);
+  for (const s21::PlotResult &result : inbox.Results()) {
+    EXPECT_FALSE(result.provisional);
+  }
+}
+
+TEST(PlotWorkerTest, cachedViewOnlyPanEvaluatesNothing) {
+  Inbox inbox;
+  auto tiles = std::make_shared<s21::TileCache>();
+  s21::PlotWorker worker(2, s21::ExpressionCache::Shared(), tiles);
+  worker.SetCallback(inbox.Callback());
+  s21::PlotRequest request = Request("1/x + sin(10*x)");
+  request.sampling = s21::ViewportSampling(800, 600, 1, 100000);
+  request.low_y = -5;
+  request.high_y = 5;
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  s21::PlotResult full = inbox.Results().back();
+  EXPECT_GT(full.evaluations, 0u);
+  EXPECT_FALSE(full.roots.empty());
+  EXPECT_GT(full.integral.evaluations, 0u);
+
+  // Away and back, the curve only: the way back is all cached.
+  request.range = request.markers = request.integral = false;
+  request.low_x += 10;
+  request.high_x += 10;
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  EXPECT_GT(inbox.Results().back().evaluations, 0u);
+  size_t misses = tiles->Stats().misses;
+  request.low_x -= 10;
+  request.high_x -= 10;
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  s21::PlotResult pan = inbox.Results().back();
+  EXPECT_EQ(tiles->Stats().misses, misses);
+  EXPECT_EQ(pan.evaluations, 0u);
+  EXPECT_EQ(pan.x, full.x);
+  EXPECT_TRUE(pan.range.isEmpty());
+  EXPECT_TRUE(pan.roots.empty());
+  EXPECT_TRUE(pan.extrema.empty());
+  EXPECT_EQ(pan.integral.evaluations, 0u);
+}
+
+TEST(PlotWorkerTest, tileScaleStaysWithTheLevel) {
+  Inbox inbox;
+  auto tiles = std::make_shared<s21::TileCache>();
+  s21::PlotWorker worker(2, s21::ExpressionCache::Shared(), tiles);
+  worker.SetCallback(inbox.Callback());
+  s21::PlotRequest request = Request("x^2");
+  request.sampling = s21::ViewportSampling(800, 600, 1, 100000);
+  request.range = request.markers = request.integral = false;
+  // Tiles of 8 units, -2 to 1 in view.
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  EXPECT_EQ(tiles->Stats().misses, 4u);
+
+  // The spread in view more than doubles, which would round to another
+  // scale, but the tiles, all cached, are taken as they are.
+  request.low_x += 5;
+  request.high_x += 5;
+  ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+  s21::PlotResult pan = inbox.Results().back();
+  EXPECT_EQ(tiles->Stats().misses, 4u);
+  EXPECT_EQ(tiles->Stats().hits, 3u);
+  EXPECT_EQ(pan.evaluations, 0u);
+  EXPECT_FALSE(pan.x.empty());
+}
+
+// Submit-to-plot time for a 1e5-point curve, and the part of it that runs
+// after delivery, on the GUI thread. The copying path goes through
+// PlotResult::x and y and then makes the copies the graph used to make: the
+// queued signal's copy of the result, two QVectors, QCPGraph's interleaving
+// and its sort. The sink path builds the interleaved buffer once on the
+// worker, leaving only a pointer swap on the GUI thread.
+TEST(PlotWorkerBenchmark, handoffThroughput) {
+  struct Point {
+    double key, value;
+  };
+  using Clock = std::chrono::steady_clock;
+  s21::PlotRequest request = Request("sin(x)*x", 100000);
+  request.sampling.initial_points = 100000;
+  request.range = request.markers = request.integral = false;
+
+  Inbox inbox;
+  s21::PlotWorker worker(2);
+  worker.SetCallback(inbox.Callback());
+  double copying = INFINITY, copying_gui = INFINITY;
+  double sink = INFINITY, sink_gui = INFINITY;
+  std::vector<Point> copied, sunk;
+  for (int round = 0; round < 5; ++round) {
+    auto start = Clock::now();
+    ASSERT_TRUE(inbox.WaitFor(worker.Submit(request)));
+    auto delivered = Clock::now();
+    s21::PlotResult result = inbox.Results().back();
+    std::vector<double> keys(result.x), values(result.y);
+    copied.clear();
+    for (size_t i = 0; i < keys.size(); ++i) {
+      copied.push_back({keys[i], values[i]});
+    }
+    std::sort(copied.begin(), copied.end(),
+              [](const Point &a, const Point &b) { return a.key < b.key; });
+    auto done = Clock::now();
+    copying = std::min(copying,
+                       std::chrono::duration<double>(done - start).count());
+    copying_gui = std::min(
+        copying_gui, std::chrono::duration<double>(done - delivered).count());
+
+    auto buffer = std::make_shared<std::vector<Point>>();
+    s21::PlotRequest direct = request;
+    direct.sink = [buffer](const double *xs, const double *ys, size_t count) {
+      buffer->reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        buffer->push_back({xs[i], ys[i]});
+      }
+    };
+    start = Clock::now();
+    ASSERT_TRUE(inbox.WaitFor(worker.Submit(direct)));
+    delivered = Clock::now();
+    s21::PlotResult adopted = inbox.Results().back();
+    EXPECT_TRUE(adopted.x.empty());
+    sunk.swap(*buffer);
+    done = Clock::now();
+    sink = std::min(sink, std::chrono::duration<double>(done - start).count());
+    sink_gui = std::min(
+        sink_gui, std::chrono::duration<double>(done - delivered).count());
+  }
+
+  ASSERT_EQ(sunk.size(), copied.size());
+  EXPECT_GE(sunk.size(), 100000u);
+  for (size_t i = 0; i < sunk.size(); ++i) {
+    ASSERT_EQ(sunk[i].key, copied[i].key);
+  }
+  std::cout << "[ handoff  ] copying " << copying * 1e3 << " ms ("
+            << copying_gui * 1e3 << " ms after delivery), sink " << sink * 1e3
+            << " ms (" << sink_gui * 1e3 << " ms after delivery)\n";
+  RecordProperty("copying_ms", std::to_string(copying * 1e3));
+  RecordProperty("copying_after_delivery_ms",
+                 std::to_string(copying_gui * 1e3));
+  RecordProperty("sink_ms", std::to_string(sink * 1e3));
+  RecordProperty("sink_after_delivery_ms", std::to_string(sink_gui * 1e3));
+}
+
+}  // namespace
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/roots.h"
+
+namespace {
+
+void ExpectNear(const std::vector<double> &actual,
+                const std::vector<double> &expected, double tolerance) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], tolerance) << i;
+  }
+}
+
+TEST(RootFinderTest, findsSignChanges) {
+  s21::CalculatorModel model;
+  ExpectNear(model.FindRoots("sin(x)", -10, 10),
+             {-3 * M_PI, -2 * M_PI, -M_PI, 0, M_PI, 2 * M_PI, 3 * M_PI},
+             1e-14);
+  ExpectNear(model.FindRoots("x^3-2*x", -3, 3),
+             {-std::sqrt(2), 0, std::sqrt(2)}, 1e-15);
+  ExpectNear(model.FindRoots("sqrt(x)-1", -5, 5), {1}, 1e-15);
+  ExpectNear(model.FindRoots("x-2", -2, 2), {2}, 0);
+  EXPECT_TRUE(model.FindRoots("x^2+1", -5, 5).empty());
+}
+
+TEST(RootFinderTest, skipsPolesAndSteps) {
+  s21::CalculatorModel model;
+  ExpectNear(model.FindRoots("tan(x)", -5, 5), {-M_PI, 0, M_PI}, 1e-14);
+  EXPECT_TRUE(model.FindRoots("1/x", -1, 1).empty());
+  ExpectNear(model.FindRoots("1/x - 2", -1, 1), {0.5}, 1e-15);
+  ExpectNear(model.FindRoots("x mod 1 - 0.5", 0, 3), {0.5, 1.5, 2.5}, 1e-15);
+  ExpectNear(model.FindRoots("(x-1)^3", -3, 3), {1}, 1e-5);
+}
+
+TEST(RootFinderTest, findsExtrema) {
+  s21::CalculatorModel model;
+  std::vector<s21::Extremum> extrema = model.FindExtrema("sin(x)", 0, 10);
+  ASSERT_EQ(extrema.size(), 3u);
+  for (size_t i = 0; i < extrema.size(); ++i) {
+    EXPECT_NEAR(extrema[i].x, M_PI_2 + i * M_PI, 1e-8);
+    EXPECT_NEAR(extrema[i].y, i % 2 ? -1 : 1, 1e-15);
+    EXPECT_EQ(extrema[i].maximum, i % 2 == 0);
+  }
+  extrema = model.FindExtrema("(x-1)^2+3", -4, 4);
+  ASSERT_EQ(extrema.size(), 1u);
+  EXPECT_NEAR(extrema[0].x, 1, 1e-15);
+  EXPECT_DOUBLE_EQ(extrema[0].y, 3);
+  EXPECT_FALSE(extrema[0].maximum);
+  EXPECT_TRUE(model.FindExtrema("x^3", -2, 2).empty());
+  EXPECT_TRUE(model.FindExtrema("tan(x)", -5, 5).empty());
+}
+
+TEST(RootFinderTest, parallelMatchesSerial) {
+  s21::CalculatorModel serial, parallel;
+  parallel.EnableParallelSampling(true, 4, 512);
+  for (const char *input : {"sin(1/x)", "cos(x)*x - 1", "x mod 1 - 0.5"}) {
+    EXPECT_EQ(parallel.FindRoots(input, -3, 3), serial.FindRoots(input, -3, 3))
+        << input;
+    std::vector<s21::Extremum> a = parallel.FindExtrema(input, -3, 3);
+    std::vector<s21::Extremum> b = serial.FindExtrema(input, -3, 3);
+    ASSERT_EQ(a.size(), b.size()) << input;
+    for (size_t i = 0; i < a.size(); ++i) EXPECT_EQ(a[i].x, b[i].x);
+  }
+  s21::CompiledExpression expression = serial.Compile("sin(1/x)");
+  s21::RootFinder finder(expression, nullptr, 100000);
+  std::vector<double> fine = finder.FindRoots(0.001, 1);
+  EXPECT_GT(fine.size(), serial.FindRoots("sin(1/x)", 0.001, 1).size());
+  for (double x : fine) {
+    double k = 1 / (x * M_PI);
+    EXPECT_NEAR(k, std::round(k), 1e-9 * k);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,289 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/sampler.h"
+
+namespace {
+
+using Samples = std::pair<std::vector<double>, std::vector<double>>;
+
+// Largest vertical distance, in pixels, between the polyline through samples
+// and the true curve, probed at a dense uniform grid.
+double MaxPixelError(s21::CalculatorModel &model, const std::string &input,
+                     const Samples &xy, double low_y, double high_y,
+                     double height) {
+  double worst = 0;
+  double low_x = xy.first.front(), high_x = xy.first.back();
+  for (int i = 0; i <= 200000; ++i) {
+    double x = low_x + (high_x - low_x) * i / 200000;
+    size_t k = std::upper_bound(xy.first.begin(), xy.first.end(), x) -
+               xy.first.begin();
+    if (k == 0 || k >= xy.first.size()) continue;
+    double x0 = xy.first[k - 1], x1 = xy.first[k];
+    double y0 = xy.second[k - 1], y1 = xy.second[k];
+    double line = y0 + (y1 - y0) * (x - x0) / (x1 - x0);
+    double y = model.Calculate(input, x);
+    double error = std::fabs(line - y) / (high_y - low_y) * height;
+    if (std::isfinite(error)) worst = std::max(worst, error);
+  }
+  return worst;
+}
+
+TEST(SamplerTest, flatCurvesStayCoarse) {
+  s21::CalculatorModel model;
+  Samples xy = model.CalculateAdaptive("2*x+1", -10, 10, 0, 0);
+  EXPECT_LE(model.LastEvaluationCount(), 2 * 257u);
+  EXPECT_TRUE(std::is_sorted(xy.first.begin(), xy.first.end()));
+  EXPECT_EQ(xy.first.front(), -10);
+  EXPECT_EQ(xy.first.back(), 10);
+  for (size_t i = 0; i < xy.first.size(); ++i) {
+    EXPECT_DOUBLE_EQ(xy.second[i], 2 * xy.first[i] + 1);
+  }
+}
+
+TEST(SamplerTest, refinesSharpFeatures) {
+  s21::CalculatorModel model;
+  s21::SamplingOptions options;
+  options.height = 600;
+  Samples xy = model.CalculateAdaptive("sin(1/x)", -1, 1, -1.5, 1.5, options);
+  size_t evaluations = model.LastEvaluationCount();
+  EXPECT_LT(evaluations, 100000u);
+  EXPECT_LE(xy.first.size(), evaluations + 100);
+  EXPECT_TRUE(std::is_sorted(xy.first.begin(), xy.first.end()));
+
+  size_t near_zero = 0, far = 0;
+  for (double x : xy.first) {
+    if (std::fabs(x) < 0.1) ++near_zero;
+    if (std::fabs(x) > 0.9) ++far;
+  }
+  EXPECT_GT(near_zero, 10 * far);
+
+  // Away from the accumulation point the polyline is within tolerance.
+  Samples tail;
+  for (size_t i = 0; i < xy.first.size(); ++i) {
+    if (xy.first[i] >= 0.05) {
+      tail.first.push_back(xy.first[i]);
+      tail.second.push_back(xy.second[i]);
+    }
+  }
+  EXPECT_LT(MaxPixelError(model, "sin(1/x)", tail, -1.5, 1.5, 600), 1.0);
+
+  Samples uniform = model.Calculate("sin(1/x)", -1, 1, 0, 0, evaluations);
+  Samples uniform_tail;
+  for (size_t i = 0; i < uniform.first.size(); ++i) {
+    if (uniform.first[i] >= 0.05) {
+      uniform_tail.first.push_back(uniform.first[i]);
+      uniform_tail.second.push_back(uniform.second[i]);
+    }
+  }
+  EXPECT_GT(MaxPixelError(model, "sin(1/x)", uniform_tail, -1.5, 1.5, 600),
+            MaxPixelError(model, "sin(1/x)", tail, -1.5, 1.5, 600));
+}
+
+TEST(SamplerTest, respectsBudgetAndClipsRange) {
+  s21::CalculatorModel model;
+  s21::SamplingOptions options;
+  options.max_points = 1000;
+  Samples xy = model.CalculateAdaptive("sin(1/x)", -1, 1, -0.5, 0.5, options);
+  // Break probes, 12 evaluations each, come on top of max_points.
+  EXPECT_LE(model.LastEvaluationCount(), 1000u + 12 * 400);
+  for (double y : xy.second) {
+    EXPECT_TRUE(std::isnan(y) || (y >= -0.5 && y <= 0.5));
+  }
+  options.detect_breaks = false;
+  model.CalculateAdaptive("sin(1/x)", -1, 1, -0.5, 0.5, options);
+  EXPECT_LE(model.LastEvaluationCount(), 1000u);
+}
+
+TEST(SamplerTest, locatesDomainEdges) {
+  s21::CalculatorModel model;
+  Samples xy = model.CalculateAdaptive("sqrt(x - 0.3)", -1, 1, 0, 0);
+  double first_finite = NAN;
+  for (size_t i = 0; i < xy.first.size(); ++i) {
+    if (!std::isnan(xy.second[i])) {
+      first_finite = xy.first[i];
+      break;
+    }
+  }
+  EXPECT_NEAR(first_finite, 0.3, 2.0 / 800);
+}
+
+TEST(SamplerTest, degenerateRange) {
+  s21::AdaptiveSampler sampler;
+  auto constant = [](const double *, double *out, size_t count) {
+    std::fill(out, out + count, 3.0);
+  };
+  Samples xy = sampler.Sample(constant, 1, 1, 0, 0);
+  EXPECT_EQ(sampler.Evaluations(), 257u);
+  EXPECT_EQ(xy.second, std::vector<double>(257, 3.0));
+}
+
+size_t CountSeparators(const Samples &xy) {
+  size_t separators = 0;
+  for (size_t i = 1; i + 1 < xy.second.size(); ++i) {
+    if (std::isnan(xy.second[i]) && !std::isnan(xy.second[i - 1]) &&
+        !std::isnan(xy.second[i + 1])) {
+      ++separators;
+    }
+  }
+  return separators;
+}
+
+// Largest jump between two neighbouring samples that are both drawn.
+double LargestDrawnJump(const Samples &xy) {
+  double largest = 0;
+  for (size_t i = 0; i + 1 < xy.second.size(); ++i) {
+    double jump = std::fabs(xy.second[i + 1] - xy.second[i]);
+    if (!std::isnan(jump)) largest = std::max(largest, jump);
+  }
+  return largest;
+}
+
+// Largest drawn segment whose ends have opposite signs.
+double LargestDrawnSignFlip(const Samples &xy) {
+  double largest = 0;
+  for (size_t i = 0; i + 1 < xy.second.size(); ++i) {
+    double a = xy.second[i], b = xy.second[i + 1];
+    if (a * b < 0) largest = std::max(largest, std::fabs(b - a));
+  }
+  return largest;
+}
+
+TEST(SamplerTest, breaksAtPoles) {
+  s21::CalculatorModel model;
+  s21::SamplingOptions options;
+  options.max_points = 4000;
+  Samples xy = model.CalculateAdaptive("tan(x)", -5, 5, 0, 0, options);
+  EXPECT_EQ(CountSeparators(xy), 4u);
+  EXPECT_LT(LargestDrawnSignFlip(xy), 1);
+  for (size_t i = 1; i + 1 < xy.second.size(); ++i) {
+    if (std::isnan(xy.second[i])) {
+      double pole = std::round(xy.first[i] / M_PI - 0.5) * M_PI + M_PI_2;
+      EXPECT_NEAR(xy.first[i], pole, 1e-3);
+    }
+  }
+
+  xy = model.CalculateAdaptive("1/x", -1, 1, 0, 0, options);
+  EXPECT_EQ(CountSeparators(xy), 1u);
+  xy = model.CalculateAdaptive("1/x", -1, 1, -10, 10, options);
+  for (size_t i = 0; i + 1 < xy.second.size(); ++i) {
+    EXPECT_FALSE(xy.second[i] < -5 && xy.second[i + 1] > 5);
+  }
+}
+
+TEST(SamplerTest, breaksAtSteps) {
+  s21::CalculatorModel model;
+  Samples xy = model.CalculateAdaptive("x mod 3", 0.5, 10, 0, 0);
+  EXPECT_EQ(CountSeparators(xy), 3u);
+  EXPECT_LT(LargestDrawnJump(xy), 0.1);
+}
+
+TEST(SamplerTest, keepsContinuousCurvesWhole) {
+  s21::CalculatorModel model;
+  for (const char *input : {"x^3", "atan(20*x)", "sin(x)*10", "sqrt(x)"}) {
+    Samples xy = model.CalculateAdaptive(input, -3, 3, 0, 0);
+    EXPECT_EQ(CountSeparators(xy), 0u) << input;
+  }
+  s21::SamplingOptions options;
+  options.detect_breaks = false;
+  Samples xy = model.CalculateAdaptive("tan(x)", -5, 5, 0, 0, options);
+  EXPECT_EQ(CountSeparators(xy), 0u);
+}
+
+TEST(SamplerTest, viewportSamplingKeepsToPixelColumns) {
+  s21::CalculatorModel model;
+  s21::SamplingOptions options = s21::ViewportSampling(400, 300, 1.5, 100000);
+  EXPECT_EQ(options.width, 600);
+  EXPECT_EQ(options.max_points, 1200u);
+  for (const char *input : {"sin(1/x)", "x^3", "sqrt(x)"}) {
+    Samples xy = model.CalculateAdaptive(input, -5, 5, 0, 0, options);
+    EXPECT_LE(model.LastEvaluationCount(), options.max_points) << input;
+    std::vector<size_t> columns(600);
+    for (size_t i = 0; i < xy.first.size(); ++i) {
+      ASSERT_GE(xy.first[i], -5);
+      ASSERT_LE(xy.first[i], 5);
+      if (!std::isnan(xy.second[i])) {
+        ++columns[std::min<size_t>((xy.first[i] + 5) / 10 * 600, 599)];
+      }
+    }
+    EXPECT_LE(*std::max_element(columns.begin(), columns.end()), 3u) << input;
+  }
+  // Breaks add their two sides and a separator on top.
+  Samples xy = model.CalculateAdaptive("tan(x)", -5, 5, 0, 0, options);
+  EXPECT_EQ(CountSeparators(xy), 4u);
+  EXPECT_LE(xy.first.size(), options.max_points + 3 * 4);
+  EXPECT_EQ(s21::ViewportSampling(50, 50, 1, 100000).initial_points, 100u);
+  EXPECT_EQ(s21::ViewportSampling(400, 300, 2, 1000).max_points, 1000u);
+}
+
+// Drawn segments whose ends are on different branches of the curve, which
+// a separator at every break leaves none of.
+size_t JoinedBreaks(const Samples &xy, double (*branch)(double)) {
+  size_t joined = 0;
+  for (size_t i = 0; i + 1 < xy.first.size(); ++i) {
+    if (!std::isnan(xy.second[i]) && !std::isnan(xy.second[i + 1]) &&
+        branch(xy.first[i]) != branch(xy.first[i + 1])) {
+      ++joined;
+    }
+  }
+  return joined;
+}
+
+// Refinement takes every point the pixel columns allow on these, and the
+// break probes still reach all 64 poles and 66 steps.
+TEST(SamplerTest, viewportSamplingSeparatesEveryBreak) {
+  s21::CalculatorModel model;
+  auto pole = [](double x) { return std::floor(x / M_PI - 0.5); };
+  // x mod 3 takes the sign of x, so 0 is not a step.
+  auto step = [](double x) {
+    return x < 0 ? std::ceil(x / 3) : std::floor(x / 3);
+  };
+  for (double width : {300, 500, 800}) {
+    s21::SamplingOptions options =
+        s21::ViewportSampling(width, 600, 1, 100000);
+    Samples xy = model.CalculateAdaptive("tan(x)", -100, 100, 0, 0, options);
+    EXPECT_EQ(JoinedBreaks(xy, pole), 0u) << width;
+    EXPECT_EQ(CountSeparators(xy), 64u) << width;
+    xy = model.CalculateAdaptive("x mod 3", -100, 100, 0, 0, options);
+    EXPECT_EQ(JoinedBreaks(xy, step), 0u) << width;
+    EXPECT_EQ(CountSeparators(xy), 66u) << width;
+  }
+}
+
+TEST(SamplerTest, givenScaleReplacesTheSpread) {
+  s21::CalculatorModel model;
+  s21::SamplingOptions options;
+  Samples grid = model.Calculate("x^3", -3, 3, 0, 0, options.initial_points);
+  Samples xy = model.CalculateAdaptive("x^3", -3, 3, 0, 0, options);
+  size_t evaluations = model.LastEvaluationCount();
+
+  options.scale = s21::AdaptiveSampler(options).VerticalScale(
+      std::vector<double>(grid.second.begin(), grid.second.end()), 0, 0);
+  EXPECT_GT(options.scale, 0);
+  EXPECT_EQ(model.CalculateAdaptive("x^3", -3, 3, 0, 0, options).first,
+            xy.first);
+  EXPECT_EQ(model.LastEvaluationCount(), evaluations);
+  options.scale *= 64;
+  model.CalculateAdaptive("x^3", -3, 3, 0, 0, options);
+  EXPECT_GT(model.LastEvaluationCount(), evaluations);
+}
+
+TEST(SamplerTest, stopsWhenCancelled) {
+  s21::CalculatorModel model;
+  std::atomic<bool> cancel{true};
+  s21::SamplingOptions options;
+  options.cancel = &cancel;
+  Samples xy = model.CalculateAdaptive("sin(1/x)", -1, 1, 0, 0, options);
+  EXPECT_EQ(model.LastEvaluationCount(), options.initial_points);
+  EXPECT_EQ(xy.first.size(), options.initial_points);
+  cancel = false;
+  xy = model.CalculateAdaptive("sin(1/x)", -1, 1, 0, 0, options);
+  EXPECT_GT(model.LastEvaluationCount(), options.initial_points);
+}
+
+}  // namespace
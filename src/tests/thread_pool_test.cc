@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/thread_pool.h"
+
+namespace {
+
+TEST(ThreadPoolTest, coversEveryIndexOnce) {
+  s21::ThreadPool pool(4);
+  EXPECT_EQ(pool.ThreadCount(), 4u);
+  for (size_t grain : {1, 7, 1000, 100000}) {
+    std::vector<std::atomic<int>> hits(10007);
+    pool.ParallelFor(hits.size(), grain, [&](size_t begin, size_t end) {
+      EXPECT_LE(end - begin, grain);
+      for (size_t i = begin; i < end; ++i) ++hits[i];
+    });
+    for (const std::atomic<int> &hit : hits) ASSERT_EQ(hit, 1);
+  }
+  bool called = false;
+  pool.ParallelFor(0, 10, [&](size_t, size_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST(ThreadPoolTest, singleThreadRunsInline) {
+  s21::ThreadPool pool(1);
+  EXPECT_EQ(pool.ThreadCount(), 1u);
+  std::thread::id caller = std::this_thread::get_id();
+  pool.ParallelFor(100, 3, [&](size_t begin, size_t end) {
+    EXPECT_EQ(begin, 0u);
+    EXPECT_EQ(end, 100u);
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+  });
+}
+
+TEST(ThreadPoolTest, nestedAndConcurrentCalls) {
+  s21::ThreadPool pool(3);
+  std::atomic<size_t> total{0};
+  pool.ParallelFor(16, 1, [&](size_t, size_t) {
+    pool.ParallelFor(100, 10, [&](size_t begin, size_t end) {
+      total += end - begin;
+    });
+  });
+  EXPECT_EQ(total, 1600u);
+
+  std::atomic<size_t> sum{0};
+  std::vector<std::thread> callers;
+  for (int t = 0; t < 4; ++t) {
+    callers.emplace_back([&]() {
+      pool.ParallelFor(1000, 50, [&](size_t begin, size_t end) {
+        sum += end - begin;
+      });
+    });
+  }
+  for (std::thread &caller : callers) caller.join();
+  EXPECT_EQ(sum, 4000u);
+}
+
+TEST(ThreadPoolTest, rethrowsFirstError) {
+  s21::ThreadPool pool(2);
+  EXPECT_THROW(pool.ParallelFor(100, 10,
+                                [](size_t begin, size_t) {
+                                  if (begin == 50) {
+                                    throw std::runtime_error("chunk");
+                                  }
+                                }),
+               std::runtime_error);
+  std::atomic<size_t> after{0};
+  pool.ParallelFor(100, 10, [&](size_t b, size_t e) { after += e - b; });
+  EXPECT_EQ(after, 100u);
+}
+
+TEST(ThreadPoolTest, parallelSamplingIsDeterministic) {
+  s21::CalculatorModel serial, parallel;
+  parallel.EnableParallelSampling(true, 4, 1000);
+  EXPECT_EQ(parallel.SamplingThreads(), 4u);
+  for (const char *input : {"sin(1/x)*x", "tan(x)", "x^3-2*x"}) {
+    auto expected = serial.Calculate(input, -10, 10, -5, 5, 100003);
+    auto actual = parallel.Calculate(input, -10, 10, -5, 5, 100003);
+    EXPECT_EQ(actual.first, expected.first);
+    ASSERT_EQ(actual.second.size(), expected.second.size());
+    for (size_t i = 0; i < expected.second.size(); ++i) {
+      if (std::isnan(expected.second[i])) {
+        ASSERT_TRUE(std::isnan(actual.second[i])) << input << " " << i;
+      } else {
+        ASSERT_EQ(actual.second[i], expected.second[i]) << input << " " << i;
+      }
+    }
+  }
+  std::vector<double> xs(50000), a(xs.size()), b(xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) xs[i] = i * 1e-3;
+  serial.EvaluateBatch("sqrt(x)*ln(x)", xs.data(), a.data(), xs.size());
+  parallel.EvaluateBatch("sqrt(x)*ln(x)", xs.data(), b.data(), xs.size());
+  EXPECT_EQ(a.size(), b.size());
+  for (size_t i = 1; i < xs.size(); ++i) ASSERT_EQ(a[i], b[i]);
+  parallel.EnableParallelSampling(false);
+  EXPECT_EQ(parallel.SamplingThreads(), 1u);
+}
+
+}  // namespace
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../model/calculator.h"
+#include "../model/tile_cache.h"
+
+namespace {
+
+using s21::TileCache;
+
+const s21::SamplingOptions kOptions;
+
+// Nine uniform samples of x^2 per tile, counting the tiles sampled.
+TileCache::Sampler Squares(int &sampled) {
+  return [&sampled](double low, double high, const s21::SamplingOptions &,
+                    TileCache::Tile &tile) {
+    ++sampled;
+    for (int i = 0; i <= 8; ++i) {
+      double x = low + (high - low) * i / 8;
+      tile.x.push_back(x);
+      tile.y.push_back(x * x);
+    }
+    return true;
+  };
+}
+
+void ExpectCovers(const TileCache::Samples &xy, double low, double high) {
+  ASSERT_FALSE(xy.first.empty());
+  EXPECT_TRUE(std::is_sorted(xy.first.begin(), xy.first.end()));
+  EXPECT_LE(xy.first.front(), low);
+  EXPECT_GE(xy.first.back(), high);
+}
+
+void ExpectCurve(const TileCache::Samples &xy, double low, double high) {
+  ExpectCovers(xy, low, high);
+  for (size_t i = 0; i < xy.first.size(); ++i) {
+    EXPECT_EQ(xy.second[i], xy.first[i] * xy.first[i]);
+  }
+}
+
+TEST(TileCacheTest, levels) {
+  TileCache cache(TileCache::kBudget, 256);
+  EXPECT_EQ(cache.Level(1.0 / 256), 0);
+  EXPECT_EQ(cache.Level(1.0 / 128), 1);
+  EXPECT_EQ(cache.Level(1.0 / 1024), -2);
+  EXPECT_EQ(cache.Level(1.2 / 256), 0);
+  EXPECT_EQ(cache.Level(0), 0);
+}
+
+TEST(TileCacheTest, pansSampleOnlyNewTiles) {
+  TileCache cache;
+  int sampled = 0;
+  TileCache::Samples xy;
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, -10, 10, 2, Squares(sampled),
+                             xy));
+  EXPECT_EQ(sampled, 6);
+  ExpectCurve(xy, -10, 10);
+  EXPECT_EQ(xy.first.front(), -10);
+  EXPECT_EQ(xy.first.back(), 10);
+
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, -7.2, 13.2, 2, Squares(sampled),
+                             xy));
+  EXPECT_EQ(sampled, 7);
+  ExpectCurve(xy, -7.2, 13.2);
+  EXPECT_EQ(xy.first.front(), -7.5);
+  EXPECT_EQ(xy.first.back(), 13.5);
+
+  TileCache::Statistics stats = cache.Stats();
+  EXPECT_EQ(stats.hits, 5u);
+  EXPECT_EQ(stats.misses, 7u);
+  EXPECT_DOUBLE_EQ(stats.HitRatio(), 5.0 / 12);
+  EXPECT_EQ(cache.Size(), 7u);
+
+  // Other expressions and levels have tiles of their own.
+  ASSERT_TRUE(cache.Assemble("x^3", kOptions, -7.2, 13.2, 2, Squares(sampled),
+                             xy));
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, -7.2, 13.2, 3, Squares(sampled),
+                             xy));
+  EXPECT_EQ(sampled, 7 + 6 + 3);
+}
+
+TEST(TileCacheTest, standsInFromOtherLevels) {
+  TileCache cache;
+  int sampled = 0;
+  TileCache::Samples xy;
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, -8, 8, 3, Squares(sampled), xy));
+  EXPECT_EQ(sampled, 2);
+
+  // Zooming in: finer tiles are cut from the coarser ones until sampled.
+  std::vector<int64_t> missing;
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, -3, 5, 1, Squares(sampled), xy,
+                             &missing));
+  EXPECT_EQ(sampled, 2);
+  EXPECT_EQ(missing, std::vector<int64_t>({-2, -1, 0, 1, 2}));
+  EXPECT_EQ(cache.Stats().stand_ins, 5u);
+  ExpectCurve(xy, -3, 5);
+  for (double x : xy.first) {
+    EXPECT_EQ(std::fmod(x, 1), 0);
+  }
+  ASSERT_TRUE(cache.Refill("x^2", kOptions, -3, 5, 1, Squares(sampled), xy));
+  EXPECT_EQ(sampled, 7);
+  EXPECT_EQ(cache.Stats().hits, 0u);
+
+  // Zooming out: a coarser tile is made of the two below it.
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 20, 24, 1, Squares(sampled), xy));
+  EXPECT_EQ(sampled, 9);
+  missing.clear();
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 20, 24, 2, Squares(sampled), xy,
+                             &missing));
+  EXPECT_EQ(missing, std::vector<int64_t>({5}));
+  EXPECT_EQ(cache.Stats().stand_ins, 6u);
+  ExpectCurve(xy, 20, 24);
+  EXPECT_EQ(xy.first.size(), 17u);
+
+  // Neither: left as a gap.
+  missing.clear();
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 100, 110, 1, Squares(sampled), xy,
+                             &missing));
+  EXPECT_EQ(missing.size(), 5u);
+  EXPECT_EQ(xy.first.size(), 5u);
+  EXPECT_TRUE(std::all_of(xy.second.begin(), xy.second.end(),
+                          [](double y) { return std::isnan(y); }));
+  EXPECT_EQ(sampled, 9);
+}
+
+TEST(TileCacheTest, evictsLeastRecentlyUsedToBudget) {
+  TileCache cache;
+  int sampled = 0;
+  TileCache::Samples xy;
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 0, 4, 0, Squares(sampled), xy));
+  size_t tile = cache.Bytes() / 4;
+  cache.SetBudget(3 * tile);
+  EXPECT_EQ(cache.Size(), 3u);
+  EXPECT_EQ(cache.Stats().evictions, 1u);
+  EXPECT_LE(cache.Bytes(), cache.Budget());
+
+  // Tile 0 was sampled first and went out; using tile 1 keeps it over 2.
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 1, 2, 0, Squares(sampled), xy));
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 0, 1, 0, Squares(sampled), xy));
+  EXPECT_EQ(sampled, 5);
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 1, 2, 0, Squares(sampled), xy));
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 3, 4, 0, Squares(sampled), xy));
+  EXPECT_EQ(sampled, 5);
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 2, 3, 0, Squares(sampled), xy));
+  EXPECT_EQ(sampled, 6);
+
+  cache.SetBudget(tile - 1);
+  EXPECT_EQ(cache.Size(), 0u);
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 0, 1, 0, Squares(sampled), xy));
+  EXPECT_EQ(cache.Size(), 0u);
+  ExpectCurve(xy, 0, 1);
+  cache.SetBudget(TileCache::kBudget);
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, 0, 1, 0, Squares(sampled), xy));
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0u);
+  EXPECT_EQ(cache.Bytes(), 0u);
+}
+
+TEST(TileCacheTest, keepsOnlyWholeTiles) {
+  TileCache cache;
+  int sampled = 0;
+  TileCache::Sampler interrupted = [&](double, double,
+                                      const s21::SamplingOptions &,
+                                      TileCache::Tile &) {
+    ++sampled;
+    return false;
+  };
+  TileCache::Samples xy;
+  ASSERT_TRUE(cache.Assemble("x^2", kOptions, -10, 10, 2, interrupted, xy));
+  EXPECT_EQ(sampled, 1);
+  EXPECT_EQ(cache.Size(), 0u);
+
+  EXPECT_FALSE(cache.Assemble("x^2", kOptions, 0, 1000, 2, Squares(sampled),
+                              xy));
+  EXPECT_FALSE(cache.Assemble("x^2", kOptions, 1, 1, 2, Squares(sampled), xy));
+  EXPECT_FALSE(cache.Assemble("x^2", kOptions, 0, INFINITY, 2, Squares(sampled),
+                              xy));
+  EXPECT_EQ(sampled, 1);
+}
+
+TEST(TileCacheTest, keepsScalesPerLevel) {
+  TileCache cache;
+  int computed = 0;
+  auto compute = [&computed] { return double(++computed); };
+  EXPECT_EQ(cache.Scale("x^2", kOptions, 2, compute), 1);
+  EXPECT_EQ(cache.Scale("x^2", kOptions, 2, compute), 1);
+  s21::SamplingOptions scaled = kOptions;
+  scaled.scale = 8;
+  EXPECT_EQ(cache.Scale("x^2", scaled, 2, compute), 1);
+
+  EXPECT_EQ(cache.Scale("x^2", kOptions, 3, compute), 2);
+  EXPECT_EQ(cache.Scale("x^3", kOptions, 2, compute), 3);
+  s21::SamplingOptions taller = kOptions;
+  taller.height *= 2;
+  EXPECT_EQ(cache.Scale("x^2", taller, 2, compute), 4);
+  cache.Clear();
+  EXPECT_EQ(cache.Scale("x^2", kOptions, 2, compute), 5);
+}
+
+// Tile reuse over a pan of a tenth of the view per step, then zooms by
+// factors of 1.25, for a few tile sizes.
+TEST(TileCacheBenchmark, hitRatios) {
+  s21::CalculatorModel model;
+  const double width = 800;
+  for (double pixels : {64.0, 128.0, 256.0, 512.0}) {
+    TileCache cache(TileCache::kBudget, pixels);
+    size_t evaluations = 0;
+    double low = -10, high = 10;
+    auto view = [&] {
+      int level = cache.Level((high - low) / width);
+      s21::SamplingOptions options;
+      options.width = std::ldexp(1.0, level) / (high - low) * width;
+      options.max_points = 2 * options.width;
+      options.initial_points = options.width / 4;
+      TileCache::Samples xy;
+      ASSERT_TRUE(cache.Assemble(
+          "sin(x)*x", options, low, high, level,
+          [&](double from, double to, const s21::SamplingOptions &sampling,
+              TileCache::Tile &tile) {
+            auto samples =
+                model.CalculateAdaptive("sin(x)*x", from, to, 0, 0, sampling);
+            evaluations += model.LastEvaluationCount();
+            tile.x = std::move(samples.first);
+            tile.y = std::move(samples.second);
+            return true;
+          },
+          xy));
+      ExpectCovers(xy, low, high);
+    };
+    for (int step = 0; step < 40; ++step) {
+      double shift = (high - low) / 10;
+      low += shift;
+      high += shift;
+      view();
+    }
+    for (int step = 0; step < 10; ++step) {
+      double middle = (low + high) / 2, half = (high - low) / 2;
+      double factor = step < 5 ? 1 / 1.25 : 1.25;
+      low = middle - half * factor;
+      high = middle + half * factor;
+      view();
+    }
+    TileCache::Statistics stats = cache.Stats();
+    EXPECT_GT(stats.HitRatio(), 0.5);
+    std::cout << "[ tiles    ] " << pixels << " px: hit ratio "
+              << stats.HitRatio() << ", " << stats.misses << " tiles, "
+              << evaluations << " evaluations, " << cache.Bytes()
+              << " bytes\n";
+    RecordProperty("hit_ratio_" + std::to_string(int(pixels)),
+                   std::to_string(stats.HitRatio()));
+  }
+}
+
+}  // namespace
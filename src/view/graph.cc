@@ -4,9 +4,11 @@
 #include <QLabel>
 #include <QSpinBox>
 #include <QString>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QVector>
 #include <QWidget>
+#include <cmath>
 
 namespace s21 {
 
@@ -45,18 +47,36 @@ Graph::Graph(Controller &controller, QWidget *parent)
   main_vbox_ = new QVBoxLayout(this);
 
   InitQCustomPlot();
+  InitReplotScheduler();
   InitLimits();
   InitPointsBox();
   PlaceItems();
 
   setMaximumSize(800, 600);
   setMinimumSize(600, 400);
+
+  qRegisterMetaType<PlotResult>();
+  QObject::connect(this, &Graph::PlotReady, this, &Graph::ShowPlot,
+                   Qt::QueuedConnection);
+  controller_.OnPlotReady(
+      [this](PlotResult &&result) { emit PlotReady(result); });
+}
+
+Graph::~Graph() {
+  controller_.OnPlotReady(nullptr);
+  controller_.CancelPlot();
 }
 
 void Graph::InitQCustomPlot() {
   plot_ = new QCustomPlot(this);
   plot_->addGraph();
   plot_->graph(0)->setPen(QPen(Qt::blue));
+  for (QColor color : {QColor(Qt::red), QColor(Qt::darkGreen)}) {
+    QCPGraph *markers = plot_->addGraph();
+    markers->setLineStyle(QCPGraph::lsNone);
+    markers->setScatterStyle(
+        QCPScatterStyle(QCPScatterStyle::ssCircle, color, 7));
+  }
   connect(plot_->xAxis, SIGNAL(rangeChanged(QCPRange)), plot_->xAxis2,
           SLOT(setRange(QCPRange)));
   connect(plot_->yAxis, SIGNAL(rangeChanged(QCPRange)), plot_->yAxis2,
@@ -73,10 +93,18 @@ void Graph::InitLimits() {
   limits_ = new QHBoxLayout(this);
   x_limits_ = new NumberLimit("x low, high", -1e6, 1e6, -100.0, 100.0, this);
   y_limits_ = new NumberLimit("y low, high", -1e6, 1e6, 0.0, 0.0, this);
-  QObject::connect(x_limits_, &NumberLimit::textChanged, this,
-                   &Graph::PlotFromMemory);
-  QObject::connect(y_limits_, &NumberLimit::textChanged, this,
-                   &Graph::PlotFromMemory);
+  plot_->xAxis->setRange(x_limits_->Low(), x_limits_->High());
+  QObject::connect(plot_->xAxis,
+                   QOverload<const QCPRange &>::of(&QCPAxis::rangeChanged),
+                   this, &Graph::FollowView);
+  QObject::connect(x_limits_, &NumberLimit::textChanged, this, [this] {
+    plot_->xAxis->setRange(x_limits_->Low(), x_limits_->High());
+    fit_y_ = true;
+  });
+  QObject::connect(y_limits_, &NumberLimit::textChanged, this, [this] {
+    fit_y_ = true;
+    ScheduleReplot();
+  });
 }
 
 void Graph::InitPointsBox() {
@@ -89,8 +117,32 @@ void Graph::InitPointsBox() {
   points_->setRange(1, 1e5);
   points_->setValue(4000);
   points_vbox_->addWidget(points_);
+  integral_ = new QLabel(this);
+  integral_->setAlignment(Qt::AlignHCenter);
+  points_vbox_->addWidget(integral_);
   QObject::connect(points_, &QSpinBox::textChanged, this,
-                   &Graph::PlotFromMemory);
+                   &Graph::ScheduleReplot);
+}
+
+void Graph::InitReplotScheduler() {
+  replot_timer_ = new QTimer(this);
+  replot_timer_->setSingleShot(true);
+  replot_timer_->setInterval(kReplotBudgetMs);
+  QObject::connect(replot_timer_, &QTimer::timeout, this, [this] {
+    ++replot_stats_.plots;
+    PlotFromMemory();
+  });
+  QObject::connect(plot_, &QCustomPlot::afterReplot, this, [this] {
+    ++replot_stats_.replots;
+    ShowReplotStats();
+  });
+  settle_timer_ = new QTimer(this);
+  settle_timer_->setSingleShot(true);
+  settle_timer_->setInterval(kSettleMs);
+  QObject::connect(settle_timer_, &QTimer::timeout, this, [this] {
+    ++replot_stats_.plots;
+    PlotFromMemory();
+  });
 }
 
 void Graph::PlaceItems() {
@@ -112,23 +164,163 @@ void Graph::ToggleVisibility() {
   }
 }
 
+// Samples the visible x range only, on the controller's worker thread;
+// ShowPlot draws the result when it comes back.
 void Graph::PlotFromInput(const QString &input) {
   if (isHidden()) {
     pending_draw_ = true;
     expression_ = input;
     return;
   }
-  try {
-    std::pair<QVector<double>, QVector<double>> xy = controller_.Calculate(
-        input, x_limits_->Low(), x_limits_->High(), y_limits_->Low(),
-        y_limits_->High(), points_->value());
-    expression_ = input;
-    plot_->graph(0)->setData(xy.first, xy.second);
-    plot_->replot();
-  } catch (std::invalid_argument &e) {
+  // Half-typed input arrives on every keystroke; skip it without unwinding.
+  if (!controller_.Prepare(input).isOk()) {
+    return;
   }
+  expression_ = input;
+  // The worker fills the container; ShowPlot hands it to the graph as is.
+  QSharedPointer<QCPGraphDataContainer> data(new QCPGraphDataContainer);
+  auto sink = [data](const double *xs, const double *ys, size_t count) {
+    QVector<QCPGraphData> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      points.append(QCPGraphData(xs[i], ys[i]));
+    }
+    data->set(points, count < 2 || xs[0] <= xs[count - 1]);
+  };
+  QCPRange view = plot_->xAxis->range();
+  plot_id_ = controller_.PlotAsync(
+      input, view.lower, view.upper, y_limits_->Low(), y_limits_->High(),
+      points_->value(), plot_->axisRect()->width(),
+      plot_->axisRect()->height(), plot_->devicePixelRatioF(),
+      settle_timer_->isActive(), sink);
+  plot_data_ = data;
+}
+
+// Called through the queued PlotReady signal, so on the GUI thread; a result
+// that a newer request superseded while it was queued is dropped.
+void Graph::ShowPlot(const PlotResult &result) {
+  if (result.id != plot_id_ || !result.status.isOk()) {
+    return;
+  } else if (result.provisional) {
+    ShowProvisional(result);
+    return;
+  }
+  const PlotRequest &request = result.request;
+  plot_->graph(0)->setData(plot_data_);
+  if (fit_y_ && (request.low_y != 0 || request.high_y != 0)) {
+    plot_->yAxis->setRange(request.low_y, request.high_y);
+  } else if (fit_y_ && request.range) {
+    AutoRange(result.range);
+  }
+  if (request.markers) {
+    PlotMarkers(result);
+  }
+  if (request.integral) {
+    ShowIntegral(result);
+  }
+  ++replot_stats_.replot_requests;
+  plot_->replot(QCustomPlot::rpQueuedReplot);
+}
+
+// Cached tiles, with the missing ones shown from other zoom levels, while
+// the worker samples the rest; plot_data_ is not filled before the result
+// proper, so the samples come in x and y.
+void Graph::ShowProvisional(const PlotResult &result) {
+  plot_->graph(0)->setData(QVector<double>(result.x.begin(), result.x.end()),
+                           QVector<double>(result.y.begin(), result.y.end()),
+                           true);
+  ++replot_stats_.replot_requests;
+  plot_->replot(QCustomPlot::rpQueuedReplot);
+}
+
+// Edits that leave the lexemes as they were, such as added whitespace, keep
+// the current plot.
+void Graph::PlotFromEdit(const QString &input) {
+  if (isHidden()) {
+    PlotFromInput(input);
+    return;
+  }
+  bool changed = true;
+  if (controller_.PrepareEdit(input, changed).isOk() && changed) {
+    fit_y_ = true;
+    PlotFromInput(input);
+  }
+}
+
+// Fits the y axis to the interval enclosure of the curve instead of scanning
+// the samples; left alone when the curve has no bounded part.
+void Graph::AutoRange(const Interval &range) {
+  if (!range.isBounded()) {
+    return;
+  }
+  double margin = (range.high - range.low) / 20;
+  if (margin <= 1e-9 * (1 + std::fabs(range.low))) {
+    margin = 1;
+  }
+  plot_->yAxis->setRange(range.low - margin, range.high + margin);
+}
+
+// Roots on graph 1, extrema on graph 2.
+void Graph::PlotMarkers(const PlotResult &result) {
+  QVector<double> roots(result.roots.begin(), result.roots.end());
+  plot_->graph(1)->setData(roots, QVector<double>(roots.size(), 0));
+  QVector<double> x, y;
+  for (const Extremum &extremum : result.extrema) {
+    x.push_back(extremum.x);
+    y.push_back(extremum.y);
+  }
+  plot_->graph(2)->setData(x, y);
+}
+
+void Graph::ShowIntegral(const PlotResult &result) {
+  if (result.request.input.empty()) {
+    integral_->clear();
+    return;
+  }
+  const Integral &integral = result.integral;
+  QString text = QString("integral %1 ± %2")
+                     .arg(integral.value, 0, 'g', 12)
+                     .arg(integral.error, 0, 'g', 2);
+  if (!integral.converged) {
+    text += " (not converged)";
+  }
+  integral_->setText(text);
 }
 
 void Graph::PlotFromMemory() { emit PlotFromInput(expression_); }
 
+// Holding a spin box arrow sends a tick per autorepeat; the first one of a
+// burst starts the timer and the rest until it fires are merged into its
+// plot, which reads the limits as they are by then.
+void Graph::ScheduleReplot() {
+  ++replot_stats_.requests;
+  if (replot_timer_->isActive()) {
+    ++replot_stats_.merged;
+    return;
+  }
+  replot_timer_->start();
+}
+
+// Dragging, zooming and the x limits all move the view, which then decides
+// what is sampled: nothing off screen is evaluated. The limits are not
+// written back: zooming goes past the spin boxes' decimals and range, and a
+// rounded bound would move the view on the next edit of the other one.
+void Graph::FollowView(const QCPRange &) {
+  fit_y_ = false;
+  settle_timer_->start();
+  ScheduleReplot();
+}
+
+// On the plot's tooltip, brought up to date after every replot drawn.
+void Graph::ShowReplotStats() {
+  const ReplotStats &stats = replot_stats_;
+  plot_->setToolTip(QString("%1 plots for %2 changes, %3 merged\n"
+                            "%4 of %5 replots drawn")
+                        .arg(stats.plots)
+                        .arg(stats.requests)
+                        .arg(stats.merged)
+                        .arg(stats.replots)
+                        .arg(stats.replot_requests));
+}
+
 };  // namespace s21
@@ -3,7 +3,9 @@
 
 #include <QDoubleSpinBox>
 #include <QLabel>
+#include <QMetaType>
 #include <QSpinBox>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QWidget>
 
@@ -36,13 +38,33 @@ class Graph : public QWidget {
 
  public:
   Graph(Controller &controller, QWidget *parent = nullptr);
+  ~Graph() override;
   void ToggleVisibility();
 
  private:
+  // Limit and point count changes requested, those merged into a plot that
+  // was already scheduled, and plots started for them; replots of finished
+  // results requested, and replots QCustomPlot actually drew.
+  struct ReplotStats {
+    size_t requests = 0;
+    size_t merged = 0;
+    size_t plots = 0;
+    size_t replot_requests = 0;
+    size_t replots = 0;
+  };
+
   void InitQCustomPlot();
   void InitLimits();
   void InitPointsBox();
   void PlaceItems();
+  void InitReplotScheduler();
+  void ScheduleReplot();
+  void FollowView(const QCPRange &range);
+  void AutoRange(const Interval &range);
+  void PlotMarkers(const PlotResult &result);
+  void ShowIntegral(const PlotResult &result);
+  void ShowProvisional(const PlotResult &result);
+  void ShowReplotStats();
 
   QVBoxLayout *main_vbox_;
 
@@ -55,16 +77,40 @@ class Graph : public QWidget {
   QVBoxLayout *points_vbox_;
   QLabel *points_label_;
   QSpinBox *points_;
+  QLabel *integral_;
 
   Controller &controller_;
 
   QString expression_;
   bool pending_draw_ = false;
+  // Fit the y axis to the next plot; cleared by dragging or zooming, so the
+  // view stays where the user put it.
+  bool fit_y_ = true;
+  size_t plot_id_ = 0;
+  QSharedPointer<QCPGraphDataContainer> plot_data_;
+
+  // Spin box ticks within this many milliseconds, a few frames and longer
+  // than a keyboard autorepeat period, share one plot.
+  static constexpr int kReplotBudgetMs = 50;
+  QTimer *replot_timer_;
+  ReplotStats replot_stats_;
+  // While the view moves, plots are the curve alone, which cached tiles make
+  // cheap; this long after the last move a full plot brings the markers,
+  // y range and integral up to date.
+  static constexpr int kSettleMs = 300;
+  QTimer *settle_timer_;
+
+ signals:
+  void PlotReady(const PlotResult &result);
 
  public slots:
   void PlotFromInput(const QString &input);
+  void PlotFromEdit(const QString &input);
   void PlotFromMemory();
+  void ShowPlot(const PlotResult &result);
 };
 };  // namespace s21
 
+Q_DECLARE_METATYPE(s21::PlotResult)
+
 #endif  // SMARTCALC_VIEW_GRAPH_H_
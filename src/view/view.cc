@@ -36,7 +36,7 @@ void View::InitTopRow() {
 
   line_edit_ = new MainLineEdit(this);
   QObject::connect(line_edit_, &QLineEdit::textChanged, graph_,
-                   &Graph::PlotFromInput);
+                   &Graph::PlotFromEdit);
   QObject::connect(line_edit_, &QLineEdit::returnPressed, this,
                    &View::Calculate);
 